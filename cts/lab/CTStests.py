@@ -1465,6 +1465,7 @@ class SplitBrainTest(CTSTest):
         self.start = StartTest(cm)
         self.startall = SimulStartLite(cm)
         self.is_experimental = 1
+        self.attr = "cts-split-brain"
 
     def isolate_partition(self, partition):
         other_nodes = []
@@ -1508,6 +1509,26 @@ class SplitBrainTest(CTSTest):
         for node in partition:
             self.CM.unisolate_node(node, other_nodes)
 
+    def check_attributes(self, partitions):
+        '''Check that every node learned every partition's attribute value'''
+        expected = None
+
+        for node in self.Env["nodes"]:
+            (rc, lines) = self.rsh(node, "attrd_updater -Q -A -n %s" % self.attr,
+                                   stdout=None)
+            lines = sorted(lines)
+            if expected is None:
+                expected = lines
+                if len(lines) != len(partitions):
+                    self.failure("Expected %d values for %s, got: %s"
+                                 % (len(partitions), self.attr, repr(lines)))
+            elif lines != expected:
+                self.failure("%s values differ between nodes: %s vs. %s"
+                             % (self.attr, repr(expected), repr(lines)))
+
+        for key in list(partitions.keys()):
+            self.rsh(partitions[key][0], "attrd_updater -n %s -D" % self.attr)
+
     def __call__(self, node):
         '''Perform split-brain test'''
         self.incr("calls")
@@ -1561,6 +1582,17 @@ class SplitBrainTest(CTSTest):
             self.failure("Audits failed")
         self.CM.partitions_expected = 1
 
+        # Give each partition a node attribute value the others don't know
+        isolated = partitions
+        for key in list(partitions.keys()):
+            self.rsh(partitions[key][0], "attrd_updater -p -n %s -U %s"
+                     % (self.attr, key))
+
+        # Writers should sync rejoining peers by attribute digests
+        watch = self.create_watch([r"pacemaker-attrd.*Processing sync-digests from"],
+                                  self.Env["DeadTime"])
+        watch.setwatch()
+
         # And heal them again
         for key in list(partitions.keys()):
             self.heal_partition(partitions[key])
@@ -1607,6 +1639,11 @@ class SplitBrainTest(CTSTest):
             if answer and answer == "n":
                 raise ValueError("Reformed cluster not stable")
 
+        watch.lookforall()
+        if watch.unmatched:
+            self.failure("Attributes were not synced by digests")
+        self.check_attributes(isolated)
+
         # Turn fencing back on
         if self.Env["DoFencing"]:
             self.rsh(node, "crm_attribute -V -D -n stonith-enabled")
@@ -44,12 +44,34 @@
  *                      PCMK__ATTRD_CMD_UPDATE_DELAY
  *     2       1.1.17   PCMK__ATTRD_CMD_CLEAR_FAILURE
  *     3       2.1.1    PCMK__ATTRD_CMD_SYNC_RESPONSE indicates remote nodes
+ *     4       2.1.4    PCMK__ATTRD_CMD_SYNC_DIGESTS, PCMK__ATTRD_CMD_SYNC with
+ *                      attribute names, partial PCMK__ATTRD_CMD_SYNC_RESPONSE
+ *     5       2.1.4    PCMK__ATTRD_CMD_UPDATE with multiple updates as children
  */
-#define ATTRD_PROTOCOL_VERSION "3"
+#define ATTRD_PROTOCOL_VERSION "5"
+
+// Minimum protocol version that supports syncing by attribute digests
+#define ATTRD_PROTOCOL_SYNC_DIGESTS 4
+
+// Minimum protocol version that supports multiple updates in one message
+#define ATTRD_PROTOCOL_UPDATE_LIST 5
 
 int last_cib_op_done = 0;
 GHashTable *attributes = NULL;
 
+/* Names of attributes whose values should be written to the CIB when the
+ * write trigger next runs, so that changes to many attributes (whether from
+ * peer updates, refreshes, or expiring dampening timers) can be combined into
+ * a single CIB request
+ */
+static GHashTable *pending_writes = NULL;
+static crm_trigger_t *write_trigger = NULL;
+
+/* Maximum number of attribute values to combine into a single CIB request
+ * (a request may exceed this if a single attribute has more values)
+ */
+#define ATTRD_MAX_BATCH_UPDATES 1000
+
 void write_attribute(attribute_t *a, bool ignore_delay);
 void write_or_elect_attribute(attribute_t *a);
 void attrd_peer_update(crm_node_t *peer, xmlNode *xml, const char *host, bool filter);
@@ -180,6 +202,156 @@ clear_attribute_value_seen(void)
     }
 }
 
+/*!
+ * \internal
+ * \brief Mark attribute values as unseen only if named in a partial sync
+ *
+ * \param[in] xml  Partial sync response XML
+ */
+static void
+clear_attribute_value_seen_partial(xmlNode *xml)
+{
+    GHashTableIter aIter;
+    GHashTableIter vIter;
+    attribute_t *a;
+    attribute_value_t *v = NULL;
+    GHashTable *synced = pcmk__strkey_table(NULL, NULL);
+
+    for (xmlNode *child = pcmk__xml_first_child(xml); child != NULL;
+         child = pcmk__xml_next(child)) {
+        const char *name = crm_element_value(child, PCMK__XA_ATTR_NAME);
+
+        if (name != NULL) {
+            g_hash_table_add(synced, (gpointer) name);
+        }
+    }
+
+    g_hash_table_iter_init(&aIter, attributes);
+    while (g_hash_table_iter_next(&aIter, NULL, (gpointer *) & a)) {
+        gboolean seen = !g_hash_table_contains(synced, a->id);
+
+        g_hash_table_iter_init(&vIter, a->values);
+        while (g_hash_table_iter_next(&vIter, NULL, (gpointer *) & v)) {
+            v->seen = seen;
+        }
+    }
+    g_hash_table_destroy(synced);
+}
+
+/*!
+ * \internal
+ * \brief Calculate a digest of everything a sync would send for an attribute
+ *
+ * \param[in] a  Attribute to digest
+ *
+ * \return Newly allocated digest of \p a
+ * \note Peers compare these digests to decide which attributes need syncing,
+ *       so anything that could make attributes differ must be included.
+ *       Extra differences just cost a resend.
+ */
+static char *
+attribute_digest(attribute_t *a)
+{
+    char *digest = NULL;
+    GList *hosts = g_list_sort(g_hash_table_get_keys(a->values),
+                               (GCompareFunc) strcasecmp);
+    GString *buffer = g_string_sized_new(256);
+
+    g_string_append_printf(buffer, "%s %s %s %s %d %d\n", a->id,
+                           crm_str(a->set), crm_str(a->uuid), crm_str(a->user),
+                           a->timeout_ms / 1000, a->is_private);
+
+    for (GList *iter = hosts; iter != NULL; iter = iter->next) {
+        attribute_value_t *v = g_hash_table_lookup(a->values, iter->data);
+
+        g_string_append_printf(buffer, "%s %u %d %c%s\n",
+                               v->nodename, v->nodeid, v->is_remote,
+                               ((v->current == NULL)? '-' : '='),
+                               crm_str(v->current));
+    }
+    g_list_free(hosts);
+
+    digest = crm_md5sum(buffer->str);
+    g_string_free(buffer, TRUE);
+    return digest;
+}
+
+/*!
+ * \internal
+ * \brief Check whether peers support a given attrd protocol version
+ *
+ * \param[in] peer     Peer to check (or NULL for all active cluster peers)
+ * \param[in] version  Minimum protocol version needed
+ *
+ * \return true if \p peer (or every active peer) is known to support
+ *         \p version, otherwise false
+ */
+static bool
+peers_support_protocol(crm_node_t *peer, int version)
+{
+    GHashTableIter iter;
+    attribute_t *a = g_hash_table_lookup(attributes, CRM_ATTR_PROTOCOL);
+    attribute_value_t *v = NULL;
+
+    if (a == NULL) {
+        return false;
+    }
+
+    if (peer != NULL) {
+        int peer_version = 0;
+
+        if (peer->uname == NULL) {
+            return false;
+        }
+        v = g_hash_table_lookup(a->values, peer->uname);
+        return (v != NULL)
+               && (pcmk__scan_min_int(v->current, &peer_version,
+                                      0) == pcmk_rc_ok)
+               && (peer_version >= version);
+    }
+
+    g_hash_table_iter_init(&iter, crm_peer_cache);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &peer)) {
+        if ((peer->uname != NULL)
+            && pcmk__str_eq(peer->state, CRM_NODE_MEMBER, pcmk__str_casei)
+            && !peers_support_protocol(peer, version)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Send peers a digest of each attribute, so they can request changes
+ *
+ * \param[in] peer  Peer to send digests to (or NULL for all peers)
+ */
+static void
+send_sync_digests(crm_node_t *peer)
+{
+    GHashTableIter aIter;
+    attribute_t *a = NULL;
+    xmlNode *sync = create_xml_node(NULL, __func__);
+
+    crm_xml_add(sync, PCMK__XA_TASK, PCMK__ATTRD_CMD_SYNC_DIGESTS);
+
+    g_hash_table_iter_init(&aIter, attributes);
+    while (g_hash_table_iter_next(&aIter, NULL, (gpointer *) & a)) {
+        xmlNode *xml = create_xml_node(sync, __func__);
+        char *digest = attribute_digest(a);
+
+        crm_xml_add(xml, PCMK__XA_ATTR_NAME, a->id);
+        crm_xml_add(xml, PCMK__XA_ATTR_DIGEST, digest);
+        free(digest);
+    }
+
+    crm_debug("Syncing attribute digests to %s",
+              peer? peer->uname : "everyone");
+    send_attrd_message(peer, sync);
+    free_xml(sync);
+}
+
 static attribute_t *
 create_attribute(xmlNode *xml)
 {
@@ -264,14 +436,32 @@ attrd_client_peer_remove(pcmk__client_t *client, xmlNode *xml)
 
 /*!
  * \internal
- * \brief Respond to a client update request
+ * \brief Pass a client update to all peers
  *
- * \param[in] xml         Root of request XML
+ * \param[in]     xml        Update XML
+ * \param[in,out] broadcast  If not NULL, add a copy of \p xml to this message
+ *                           instead of sending it now
+ */
+static void
+broadcast_update(xmlNode *xml, xmlNode *broadcast)
+{
+    if (broadcast == NULL) {
+        send_attrd_message(NULL, xml); /* ends up at attrd_peer_message() */
+    } else {
+        add_node_copy(broadcast, xml);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Process a single client update
  *
- * \return void
+ * \param[in,out] xml        Update XML
+ * \param[in,out] broadcast  If not NULL, add resulting peer updates to this
+ *                           message instead of sending them individually
  */
-void
-attrd_client_update(xmlNode *xml)
+static void
+client_update_one(xmlNode *xml, xmlNode *broadcast)
 {
     attribute_t *a = NULL;
     char *host = crm_element_value_copy(xml, PCMK__XA_ATTR_NODE_NAME);
@@ -296,7 +486,7 @@ attrd_client_update(xmlNode *xml)
                 if (status == 0) {
                     crm_trace("Matched %s with %s", attr, regex);
                     crm_xml_add(xml, PCMK__XA_ATTR_NAME, attr);
-                    send_attrd_message(NULL, xml);
+                    broadcast_update(xml, broadcast);
                 }
             }
         }
@@ -345,7 +535,71 @@ attrd_client_update(xmlNode *xml)
 
     free(host);
 
-    send_attrd_message(NULL, xml); /* ends up at attrd_peer_message() */
+    broadcast_update(xml, broadcast);
+}
+
+/*!
+ * \internal
+ * \brief Respond to a client update request
+ *
+ * \param[in] xml         Root of request XML
+ *
+ * \note The request may contain a single update, or (if it specifies neither
+ *       an attribute name nor a pattern) any number of updates as children.
+ *       If all peers support it, the resulting peer updates are sent in a
+ *       single message.
+ */
+void
+attrd_client_update(xmlNode *xml)
+{
+    const char *user = crm_element_value(xml, PCMK__XA_ATTR_USER);
+    xmlNode *broadcast = NULL;
+    bool multiple = (crm_element_value(xml, PCMK__XA_ATTR_NAME) == NULL)
+                    && (crm_element_value(xml, PCMK__XA_ATTR_PATTERN) == NULL);
+
+    if (multiple && (pcmk__xml_first_child(xml) == NULL)) {
+        client_update_one(xml, NULL); // Will log an error
+        return;
+    }
+
+    // Updates for a list or a pattern can be combined into one peer message
+    if ((crm_element_value(xml, PCMK__XA_ATTR_NAME) == NULL)
+        && peers_support_protocol(NULL, ATTRD_PROTOCOL_UPDATE_LIST)) {
+        broadcast = create_xml_node(NULL, __func__);
+        crm_xml_add(broadcast, PCMK__XA_TASK, PCMK__ATTRD_CMD_UPDATE);
+    }
+
+    if (multiple) {
+        for (xmlNode *child = pcmk__xml_first_child(xml); child != NULL;
+             child = pcmk__xml_next(child)) {
+
+            const char *op = crm_element_value(child, PCMK__XA_TASK);
+
+            if (!pcmk__strcase_any_of(op, PCMK__ATTRD_CMD_UPDATE,
+                                      PCMK__ATTRD_CMD_UPDATE_BOTH,
+                                      PCMK__ATTRD_CMD_UPDATE_DELAY, NULL)) {
+                crm_warn("Ignoring unknown %s operation in update list",
+                         crm_str(op));
+                continue;
+            }
+
+            // Only the (already verified) request user may be used
+            xml_remove_prop(child, PCMK__XA_ATTR_USER);
+            crm_xml_add(child, PCMK__XA_ATTR_USER, user);
+
+            client_update_one(child, broadcast);
+        }
+    } else {
+        client_update_one(xml, broadcast);
+    }
+
+    if (broadcast != NULL) {
+        if (pcmk__xml_first_child(broadcast) != NULL) {
+            crm_debug("Broadcasting multiple updates in one message");
+            send_attrd_message(NULL, broadcast);
+        }
+        free_xml(broadcast);
+    }
 }
 
 /*!
@@ -602,9 +856,14 @@ process_peer_sync_response(crm_node_t *peer, bool peer_won, xmlNode *xml)
 
     if (peer_won) {
         /* Initialize the "seen" flag for all attributes to cleared, so we can
-         * detect attributes that local node has but the writer doesn't.
+         * detect attributes that local node has but the writer doesn't. A
+         * partial response only covers the attributes it contains.
          */
-        clear_attribute_value_seen();
+        if (pcmk__xe_attr_is_true(xml, PCMK__XA_ATTR_PARTIAL)) {
+            clear_attribute_value_seen_partial(xml);
+        } else {
+            clear_attribute_value_seen();
+        }
     }
 
     // Process each attribute update in the sync response
@@ -623,6 +882,85 @@ process_peer_sync_response(crm_node_t *peer, bool peer_won, xmlNode *xml)
     }
 }
 
+/*!
+ * \internal
+ * \brief Request attributes that differ from a peer's sync digests
+ *
+ * \param[in] peer      Peer that sent digests
+ * \param[in] peer_won  Whether peer is the attribute writer
+ * \param[in] xml       Request XML
+ */
+static void
+process_sync_digests(crm_node_t *peer, bool peer_won, xmlNode *xml)
+{
+    GHashTableIter aIter;
+    GHashTableIter vIter;
+    attribute_t *a = NULL;
+    attribute_value_t *v = NULL;
+    xmlNode *request = NULL;
+    int n_requested = 0;
+    GHashTable *offered = pcmk__strkey_table(NULL, NULL);
+
+    crm_info("Processing " PCMK__ATTRD_CMD_SYNC_DIGESTS " from %s",
+             peer->uname);
+
+    for (xmlNode *child = pcmk__xml_first_child(xml); child != NULL;
+         child = pcmk__xml_next(child)) {
+
+        const char *name = crm_element_value(child, PCMK__XA_ATTR_NAME);
+        const char *digest = crm_element_value(child, PCMK__XA_ATTR_DIGEST);
+
+        if (name == NULL) {
+            continue;
+        }
+        g_hash_table_add(offered, (gpointer) name);
+
+        a = g_hash_table_lookup(attributes, name);
+        if (a != NULL) {
+            char *local_digest = attribute_digest(a);
+            bool same = pcmk__str_eq(digest, local_digest, pcmk__str_none);
+
+            free(local_digest);
+            if (same) {
+                continue;
+            }
+        }
+
+        if (request == NULL) {
+            request = create_xml_node(NULL, __func__);
+            crm_xml_add(request, PCMK__XA_TASK, PCMK__ATTRD_CMD_SYNC);
+        }
+        crm_xml_add(create_xml_node(request, __func__), PCMK__XA_ATTR_NAME,
+                    name);
+        n_requested++;
+    }
+
+    if (request != NULL) {
+        crm_debug("Requesting %d attribute%s from %s",
+                  n_requested, pcmk__plural_s(n_requested), peer->uname);
+        send_attrd_message(peer, request);
+        free_xml(request);
+    }
+
+    if (peer_won) {
+        /* The writer doesn't know about any attributes it didn't send digests
+         * for, so send all peers our local values for them. Any others are
+         * either in sync or will be checked when the response arrives.
+         */
+        g_hash_table_iter_init(&aIter, attributes);
+        while (g_hash_table_iter_next(&aIter, NULL, (gpointer *) & a)) {
+            gboolean seen = g_hash_table_contains(offered, a->id);
+
+            g_hash_table_iter_init(&vIter, a->values);
+            while (g_hash_table_iter_next(&vIter, NULL, (gpointer *) & v)) {
+                v->seen = seen;
+            }
+        }
+        broadcast_unseen_local_values(peer, xml);
+    }
+    g_hash_table_destroy(offered);
+}
+
 /*!
     \internal
     \brief Broadcast private attribute for local node with protocol version
@@ -667,7 +1005,20 @@ attrd_peer_message(crm_node_t *peer, xmlNode *xml)
 
     if (pcmk__strcase_any_of(op, PCMK__ATTRD_CMD_UPDATE, PCMK__ATTRD_CMD_UPDATE_BOTH,
                              PCMK__ATTRD_CMD_UPDATE_DELAY, NULL)) {
-        attrd_peer_update(peer, xml, host, FALSE);
+        if ((crm_element_value(xml, PCMK__XA_ATTR_NAME) == NULL)
+            && (pcmk__xml_first_child(xml) != NULL)) {
+
+            // Multiple updates in one message
+            for (xmlNode *child = pcmk__xml_first_child(xml); child != NULL;
+                 child = pcmk__xml_next(child)) {
+                attrd_peer_update(peer, child,
+                                  crm_element_value(child,
+                                                    PCMK__XA_ATTR_NODE_NAME),
+                                  FALSE);
+            }
+        } else {
+            attrd_peer_update(peer, xml, host, FALSE);
+        }
 
     } else if (pcmk__str_eq(op, PCMK__ATTRD_CMD_SYNC, pcmk__str_casei)) {
         attrd_peer_sync(peer, xml);
@@ -685,6 +1036,10 @@ attrd_peer_message(crm_node_t *peer, xmlNode *xml)
                && !pcmk__str_eq(peer->uname, attrd_cluster->uname, pcmk__str_casei)) {
         process_peer_sync_response(peer, peer_won, xml);
 
+    } else if (pcmk__str_eq(op, PCMK__ATTRD_CMD_SYNC_DIGESTS, pcmk__str_casei)
+               && !pcmk__str_eq(peer->uname, attrd_cluster->uname, pcmk__str_casei)) {
+        process_sync_digests(peer, peer_won, xml);
+
     } else if (pcmk__str_eq(op, PCMK__ATTRD_CMD_FLUSH, pcmk__str_casei)) {
         /* Ignore. The flush command was removed in 2.0.0 but may be
          * received from peers running older versions.
@@ -692,24 +1047,73 @@ attrd_peer_message(crm_node_t *peer, xmlNode *xml)
     }
 }
 
+/*!
+ * \internal
+ * \brief Add all of an attribute's values to a sync response
+ *
+ * \param[in,out] sync  Sync response XML
+ * \param[in]     a     Attribute to add
+ * \param[in]     peer  Peer that sync is for (for logging only)
+ */
+static void
+add_attribute_sync_xml(xmlNode *sync, attribute_t *a, crm_node_t *peer)
+{
+    GHashTableIter vIter;
+    attribute_value_t *v = NULL;
+
+    g_hash_table_iter_init(&vIter, a->values);
+    while (g_hash_table_iter_next(&vIter, NULL, (gpointer *) & v)) {
+        crm_debug("Syncing %s[%s] = %s to %s", a->id, v->nodename, v->current, peer?peer->uname:"everyone");
+        add_attribute_value_xml(sync, a, v, false);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Send attribute values to peers
+ *
+ * \param[in] peer  Peer to sync (or NULL for all peers)
+ * \param[in] xml   Sync request from \p peer, if any (if this names specific
+ *                  attributes, only those will be sent)
+ *
+ * \note If this is not in response to a request, and the peers are new enough,
+ *       only attribute digests are sent, and peers request what differs.
+ */
 void
 attrd_peer_sync(crm_node_t *peer, xmlNode *xml)
 {
     GHashTableIter aIter;
-    GHashTableIter vIter;
 
     attribute_t *a = NULL;
-    attribute_value_t *v = NULL;
-    xmlNode *sync = create_xml_node(NULL, __func__);
+    xmlNode *sync = NULL;
+
+    if ((xml == NULL)
+        && peers_support_protocol(peer, ATTRD_PROTOCOL_SYNC_DIGESTS)) {
+        send_sync_digests(peer);
+        return;
+    }
 
+    sync = create_xml_node(NULL, __func__);
     crm_xml_add(sync, PCMK__XA_TASK, PCMK__ATTRD_CMD_SYNC_RESPONSE);
 
-    g_hash_table_iter_init(&aIter, attributes);
-    while (g_hash_table_iter_next(&aIter, NULL, (gpointer *) & a)) {
-        g_hash_table_iter_init(&vIter, a->values);
-        while (g_hash_table_iter_next(&vIter, NULL, (gpointer *) & v)) {
-            crm_debug("Syncing %s[%s] = %s to %s", a->id, v->nodename, v->current, peer?peer->uname:"everyone");
-            add_attribute_value_xml(sync, a, v, false);
+    if ((xml != NULL) && (pcmk__xml_first_child(xml) != NULL)) {
+        pcmk__xe_set_bool_attr(sync, PCMK__XA_ATTR_PARTIAL, true);
+
+        for (xmlNode *child = pcmk__xml_first_child(xml); child != NULL;
+             child = pcmk__xml_next(child)) {
+
+            const char *name = crm_element_value(child, PCMK__XA_ATTR_NAME);
+
+            a = (name == NULL)? NULL : g_hash_table_lookup(attributes, name);
+            if (a != NULL) {
+                add_attribute_sync_xml(sync, a, peer);
+            }
+        }
+
+    } else {
+        g_hash_table_iter_init(&aIter, attributes);
+        while (g_hash_table_iter_next(&aIter, NULL, (gpointer *) & a)) {
+            add_attribute_sync_xml(sync, a, peer);
         }
     }
 
@@ -737,6 +1141,13 @@ attrd_peer_remove(const char *host, gboolean uncache, const char *source)
 
     g_hash_table_iter_init(&aIter, attributes);
     while (g_hash_table_iter_next(&aIter, NULL, (gpointer *) & a)) {
+        /* Remember a lost node's protocol version, so that if it rejoins, we
+         * know whether it can be synced by digests. A node only broadcasts its
+         * version when its attrd starts, and we see the node rejoin first.
+         */
+        if (!uncache && pcmk__str_eq(a->id, CRM_ATTR_PROTOCOL, pcmk__str_none)) {
+            continue;
+        }
         if(g_hash_table_remove(a->values, host)) {
             crm_debug("Removed %s[%s] for peer %s", a->id, host, source);
         }
@@ -937,11 +1348,28 @@ attrd_peer_update(crm_node_t *peer, xmlNode *xml, const char *host, bool filter)
         v = broadcast_local_value(a);
 
     } else if (!pcmk__str_eq(v->current, value, pcmk__str_casei)) {
+        bool was_synced_by_digests = false;
+
         crm_notice("Setting %s[%s]: %s -> %s " CRM_XS " from %s",
                    attr, host, v->current? v->current : "(unset)", value? value : "(unset)", peer->uname);
+        if (pcmk__str_eq(attr, CRM_ATTR_PROTOCOL, pcmk__str_none)
+            && pcmk__str_eq(host, peer->uname, pcmk__str_casei)) {
+            was_synced_by_digests = peers_support_protocol(peer,
+                                                ATTRD_PROTOCOL_SYNC_DIGESTS);
+        }
         pcmk__str_update(&v->current, value);
         a->changed = TRUE;
 
+        /* If the peer rejoined running an older version than we remembered,
+         * it ignored any digests we sent, so send it everything
+         */
+        if (was_synced_by_digests && attrd_election_won()
+            && !peers_support_protocol(peer, ATTRD_PROTOCOL_SYNC_DIGESTS)) {
+            crm_info("Peer %s no longer supports syncing by digests",
+                     peer->uname);
+            attrd_peer_sync(peer, NULL);
+        }
+
         if (pcmk__str_eq(host, attrd_cluster->uname, pcmk__str_casei)
             && pcmk__str_eq(attr, XML_CIB_ATTR_SHUTDOWN, pcmk__str_none)) {
 
@@ -1042,7 +1470,9 @@ attrd_peer_change_cb(enum crm_status_type kind, crm_node_t *peer, const void *da
                       peer->uname, state_text(peer->state), state_text(data));
             if (pcmk__str_eq(peer->state, CRM_NODE_MEMBER, pcmk__str_casei)) {
                 /* If we're the writer, send new peers a list of all attributes
-                 * (unless it's a remote node, which doesn't run its own attrd)
+                 * (unless it's a remote node, which doesn't run its own attrd).
+                 * This is just digests if we remember the peer's protocol
+                 * version from before it left and it supports them.
                  */
                 if (attrd_election_won()
                     && !pcmk_is_set(peer->flags, crm_remote_node)) {
@@ -1066,31 +1496,31 @@ attrd_peer_change_cb(enum crm_status_type kind, crm_node_t *peer, const void *da
     }
 }
 
+/*!
+ * \internal
+ * \brief Handle the result of a CIB write for one attribute
+ *
+ * \param[in] a        Attribute that was written
+ * \param[in] call_id  CIB call ID of write
+ * \param[in] rc       Legacy return code of write
+ * \param[in] batched  Whether the write included other attributes
+ */
 static void
-attrd_cib_callback(xmlNode * msg, int call_id, int rc, xmlNode * output, void *user_data)
+attribute_write_done(attribute_t *a, int call_id, int rc, bool batched)
 {
     int level = LOG_ERR;
+    bool transient = false;
     GHashTableIter iter;
     const char *peer = NULL;
     attribute_value_t *v = NULL;
 
-    char *name = user_data;
-    attribute_t *a = g_hash_table_lookup(attributes, name);
-
-    if(a == NULL) {
-        crm_info("Attribute %s no longer exists", name);
-        return;
-    }
-
     a->update = 0;
-    if (rc == pcmk_ok && call_id < 0) {
-        rc = call_id;
-    }
 
     switch (rc) {
         case pcmk_ok:
             level = LOG_INFO;
             last_cib_op_done = call_id;
+            a->write_alone = FALSE;
             if (a->timer && !a->timeout_ms) {
                 // Remove temporary dampening for failed writes
                 mainloop_timer_del(a->timer);
@@ -1103,10 +1533,21 @@ attrd_cib_callback(xmlNode * msg, int call_id, int rc, xmlNode * output, void *u
         case -ENXIO:           /* When an attr changes while the CIB is syncing a
                                 *   newer config from a node that just came up
                                 */
+        case -ENOTCONN:        /* When the CIB connection is lost */
             level = LOG_WARNING;
+            transient = true;
             break;
     }
 
+    if ((rc != pcmk_ok) && batched && !transient) {
+        /* The CIB rejected the update itself, and we don't know which
+         * attribute caused that, so write each one separately next time, so
+         * one bad entry can't hold up the rest. A transient failure says
+         * nothing about the content, so the batch is simply retried as is.
+         */
+        a->write_alone = TRUE;
+    }
+
     do_crm_log(level, "CIB update %d result for %s: %s " CRM_XS " rc=%d",
                call_id, a->id, pcmk_strerror(rc), rc);
 
@@ -1140,7 +1581,7 @@ attrd_cib_callback(xmlNode * msg, int call_id, int rc, xmlNode * output, void *u
             // Attribute has a dampening value, so use that as delay
             if (!mainloop_timer_running(a->timer)) {
                 crm_trace("Delayed re-attempted write (%dms) for %s",
-                          a->timeout_ms, name);
+                          a->timeout_ms, a->id);
                 mainloop_timer_start(a->timer);
             }
         } else {
@@ -1155,6 +1596,33 @@ attrd_cib_callback(xmlNode * msg, int call_id, int rc, xmlNode * output, void *u
     }
 }
 
+static void
+attrd_cib_callback(xmlNode * msg, int call_id, int rc, xmlNode * output, void *user_data)
+{
+    GList *names = user_data;
+    bool batched = (names != NULL) && (names->next != NULL);
+
+    if (rc == pcmk_ok && call_id < 0) {
+        rc = call_id;
+    }
+
+    for (GList *iter = names; iter != NULL; iter = iter->next) {
+        attribute_t *a = g_hash_table_lookup(attributes, iter->data);
+
+        if (a == NULL) {
+            crm_info("Attribute %s no longer exists", (char *) iter->data);
+            continue;
+        }
+        attribute_write_done(a, call_id, rc, batched);
+    }
+}
+
+static void
+free_write_names(gpointer data)
+{
+    g_list_free_full((GList *) data, free);
+}
+
 void
 write_attributes(bool all, bool ignore_delay)
 {
@@ -1181,24 +1649,49 @@ write_attributes(bool all, bool ignore_delay)
     }
 }
 
+/*!
+ * \internal
+ * \brief Add an attribute value to a status section update
+ *
+ * \param[in,out] parent  Status section update XML
+ * \param[in,out] states  Transient attribute XML already in \p parent, keyed
+ *                        by node ID (will be updated if a node is added)
+ * \param[in]     a       Attribute to add
+ * \param[in]     nodeid  UUID of node that value is for
+ * \param[in]     value   Value to add (or NULL to delete attribute)
+ */
 static void
-build_update_element(xmlNode *parent, attribute_t *a, const char *nodeid, const char *value)
+build_update_element(xmlNode *parent, GHashTable *states, attribute_t *a,
+                     const char *nodeid, const char *value)
 {
     const char *set = NULL;
-    xmlNode *xml_obj = NULL;
+    char *set_id = NULL;
+    xmlNode *xml_obj = g_hash_table_lookup(states, nodeid);
 
-    xml_obj = create_xml_node(parent, XML_CIB_TAG_STATE);
-    crm_xml_add(xml_obj, XML_ATTR_ID, nodeid);
+    if (xml_obj == NULL) {
+        xml_obj = create_xml_node(parent, XML_CIB_TAG_STATE);
+        crm_xml_add(xml_obj, XML_ATTR_ID, nodeid);
 
-    xml_obj = create_xml_node(xml_obj, XML_TAG_TRANSIENT_NODEATTRS);
-    crm_xml_add(xml_obj, XML_ATTR_ID, nodeid);
+        xml_obj = create_xml_node(xml_obj, XML_TAG_TRANSIENT_NODEATTRS);
+        crm_xml_add(xml_obj, XML_ATTR_ID, nodeid);
+        g_hash_table_insert(states, strdup(nodeid), xml_obj);
+    }
 
-    xml_obj = create_xml_node(xml_obj, XML_TAG_ATTR_SETS);
     if (a->set) {
-        crm_xml_set_id(xml_obj, "%s", a->set);
+        set_id = crm_strdup_printf("%s", a->set);
     } else {
-        crm_xml_set_id(xml_obj, "%s-%s", XML_CIB_TAG_STATUS, nodeid);
+        set_id = crm_strdup_printf("%s-%s", XML_CIB_TAG_STATUS, nodeid);
+    }
+    crm_xml_sanitize_id(set_id);
+
+    // Several attributes may be going into the same set
+    parent = xml_obj;
+    xml_obj = pcmk__xe_match(parent, XML_TAG_ATTR_SETS, XML_ATTR_ID, set_id);
+    if (xml_obj == NULL) {
+        xml_obj = create_xml_node(parent, XML_TAG_ATTR_SETS);
+        crm_xml_add(xml_obj, XML_ATTR_ID, set_id);
     }
+    free(set_id);
     set = ID(xml_obj);
 
     xml_obj = create_xml_node(xml_obj, XML_CIB_TAG_NVPAIR);
@@ -1249,50 +1742,28 @@ send_alert_attributes_value(attribute_t *a, GHashTable *t)
     }
 }
 
-void
-write_attribute(attribute_t *a, bool ignore_delay)
+/*!
+ * \internal
+ * \brief Process an attribute's values for a write
+ *
+ * \param[in,out] a       Attribute to process
+ * \param[in,out] xml_top Status section update XML to add values to (or NULL
+ *                        if \p a is private)
+ * \param[in,out] states  Transient attribute XML already in \p xml_top, keyed
+ *                        by node ID
+ * \param[in,out] flags   CIB call options for update (may be updated)
+ *
+ * \return Number of values added to \p xml_top
+ */
+static int
+add_attribute_values(attribute_t *a, xmlNode *xml_top, GHashTable *states,
+                     enum cib_call_options *flags)
 {
     int private_updates = 0, cib_updates = 0;
-    xmlNode *xml_top = NULL;
     attribute_value_t *v = NULL;
     GHashTableIter iter;
-    enum cib_call_options flags = cib_quorum_override;
     GHashTable *alert_attribute_value = NULL;
 
-    if (a == NULL) {
-        return;
-    }
-
-    /* If this attribute will be written to the CIB ... */
-    if (!a->is_private) {
-
-        /* Defer the write if now's not a good time */
-        CRM_CHECK(the_cib != NULL, return);
-        if (a->update && (a->update < last_cib_op_done)) {
-            crm_info("Write out of '%s' continuing: update %d considered lost", a->id, a->update);
-            a->update = 0; // Don't log this message again
-
-        } else if (a->update) {
-            crm_info("Write out of '%s' delayed: update %d in progress", a->id, a->update);
-            return;
-
-        } else if (mainloop_timer_running(a->timer)) {
-            if (ignore_delay) {
-                /* 'refresh' forces a write of the current value of all attributes
-                 * Cancel any existing timers, we're writing it NOW
-                 */
-                mainloop_timer_stop(a->timer);
-                crm_debug("Write out of '%s': timer is running but ignore delay", a->id);
-            } else {
-                crm_info("Write out of '%s' delayed: timer is running", a->id);
-                return;
-            }
-        }
-
-        /* Initialize the status update XML */
-        xml_top = create_xml_node(NULL, XML_CIB_TAG_STATUS);
-    }
-
     /* Attribute will be written shortly, so clear changed flag */
     a->changed = FALSE;
 
@@ -1342,7 +1813,7 @@ write_attribute(attribute_t *a, bool ignore_delay)
         crm_debug("Updating %s[%s]=%s (peer known as %s, UUID %s, ID %u/%u)",
                   a->id, v->nodename, v->current,
                   peer->uname, peer->uuid, peer->id, v->nodeid);
-        build_update_element(xml_top, a, peer->uuid, v->current);
+        build_update_element(xml_top, states, a, peer->uuid, v->current);
         cib_updates++;
 
         /* Preservation of the attribute to transmit alert */
@@ -1356,7 +1827,7 @@ write_attribute(attribute_t *a, bool ignore_delay)
             /* Older attrd versions don't know about the cib_mixed_update
              * flag so make sure it goes to the local cib which does
              */
-            cib__set_call_options(flags, crm_system_name,
+            cib__set_call_options(*flags, crm_system_name,
                                   cib_mixed_update|cib_scope_local);
         }
     }
@@ -1367,24 +1838,188 @@ write_attribute(attribute_t *a, bool ignore_delay)
                  a->id, (a->uuid? a->uuid : "n/a"), (a->set? a->set : "n/a"));
     }
     if (cib_updates) {
-        crm_log_xml_trace(xml_top, __func__);
+        crm_debug("Queued %d change%s for %s (id %s, set %s)",
+                  cib_updates, pcmk__plural_s(cib_updates),
+                  a->id, (a->uuid? a->uuid : "n/a"), (a->set? a->set : "n/a"));
 
-        a->update = cib_internal_op(the_cib, CIB_OP_MODIFY, NULL, XML_CIB_TAG_STATUS, xml_top, NULL,
-                                    flags, a->user);
-
-        crm_info("Sent CIB request %d with %d change%s for %s (id %s, set %s)",
-                 a->update, cib_updates, pcmk__plural_s(cib_updates),
-                 a->id, (a->uuid? a->uuid : "n/a"), (a->set? a->set : "n/a"));
-
-        the_cib->cmds->register_callback_full(the_cib, a->update,
-                                              CIB_OP_TIMEOUT_S, FALSE,
-                                              strdup(a->id),
-                                              "attrd_cib_callback",
-                                              attrd_cib_callback, free);
         /* Transmit alert of the attribute */
         send_alert_attributes_value(a, alert_attribute_value);
     }
 
     g_hash_table_destroy(alert_attribute_value);
+    return cib_updates;
+}
+
+/*!
+ * \internal
+ * \brief Send one CIB request for as many pending attribute writes as fit
+ *
+ * Attributes are combined into one request as long as they are written as the
+ * same user, none of them must be written alone, and the request has no more
+ * than ATTRD_MAX_BATCH_UPDATES values.
+ */
+static void
+write_pending_batch(void)
+{
+    int cib_updates = 0;
+    int n_updates = 0;
+    int call_id = 0;
+    const char *user = NULL;
+    enum cib_call_options flags = cib_quorum_override;
+    xmlNode *xml_top = create_xml_node(NULL, XML_CIB_TAG_STATUS);
+    GHashTable *states = pcmk__strkey_table(free, NULL);
+    GList *names = NULL;
+    GHashTableIter iter;
+    const char *name = NULL;
+
+    g_hash_table_iter_init(&iter, pending_writes);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &name, NULL)) {
+        attribute_t *a = g_hash_table_lookup(attributes, name);
+
+        if (a == NULL) {
+            g_hash_table_iter_remove(&iter);
+            continue;
+        }
+        if ((names != NULL)
+            && (a->write_alone || !pcmk__str_eq(a->user, user, pcmk__str_none))) {
+            continue; // Leave it for another request
+        }
+        // If there's nothing to write, there's no request to wait for
+        n_updates = add_attribute_values(a, xml_top, states, &flags);
+        if (n_updates > 0) {
+            cib_updates += n_updates;
+            names = g_list_prepend(names, strdup(name));
+            user = a->user;
+        }
+        g_hash_table_iter_remove(&iter);
+
+        if (a->write_alone || (cib_updates >= ATTRD_MAX_BATCH_UPDATES)) {
+            break;
+        }
+    }
+    g_hash_table_destroy(states);
+
+    if (names != NULL) {
+        crm_log_xml_trace(xml_top, __func__);
+
+        call_id = cib_internal_op(the_cib, CIB_OP_MODIFY, NULL,
+                                  XML_CIB_TAG_STATUS, xml_top, NULL, flags,
+                                  user);
+
+        crm_info("Sent CIB request %d with changes for %d attribute%s",
+                 call_id, g_list_length(names),
+                 pcmk__plural_s(g_list_length(names)));
+
+        for (GList *iter = names; iter != NULL; iter = iter->next) {
+            attribute_t *a = g_hash_table_lookup(attributes, iter->data);
+
+            a->update = call_id;
+        }
+        the_cib->cmds->register_callback_full(the_cib, call_id,
+                                              CIB_OP_TIMEOUT_S, FALSE, names,
+                                              "attrd_cib_callback",
+                                              attrd_cib_callback,
+                                              free_write_names);
+    }
     free_xml(xml_top);
 }
+
+/*!
+ * \internal
+ * \brief Write all pending attribute changes to the CIB
+ *
+ * \param[in] user_data  Ignored
+ *
+ * \return TRUE (to indicate the trigger should remain active)
+ */
+static int
+write_pending_attributes(gpointer user_data)
+{
+    if (pending_writes == NULL) {
+        return TRUE;
+    }
+    CRM_CHECK(the_cib != NULL, return TRUE);
+
+    crm_trace("Writing %d pending attribute%s",
+              g_hash_table_size(pending_writes),
+              pcmk__plural_s(g_hash_table_size(pending_writes)));
+    while (g_hash_table_size(pending_writes) > 0) {
+        write_pending_batch();
+    }
+    return TRUE;
+}
+
+/*!
+ * \internal
+ * \brief Write any pending attribute changes and stop batching writes
+ */
+void
+attrd_flush_pending_writes(void)
+{
+    if (the_cib != NULL) {
+        write_pending_attributes(NULL);
+    }
+    if (pending_writes != NULL) {
+        g_hash_table_destroy(pending_writes);
+        pending_writes = NULL;
+    }
+    if (write_trigger != NULL) {
+        mainloop_destroy_trigger(write_trigger);
+        write_trigger = NULL;
+    }
+}
+
+void
+write_attribute(attribute_t *a, bool ignore_delay)
+{
+    if (a == NULL) {
+        return;
+    }
+
+    /* If this attribute will be written to the CIB ... */
+    if (!a->is_private) {
+
+        /* Defer the write if now's not a good time */
+        CRM_CHECK(the_cib != NULL, return);
+        if (a->update && (a->update < last_cib_op_done)) {
+            crm_info("Write out of '%s' continuing: update %d considered lost", a->id, a->update);
+            a->update = 0; // Don't log this message again
+
+        } else if (a->update) {
+            crm_info("Write out of '%s' delayed: update %d in progress", a->id, a->update);
+            return;
+
+        } else if (mainloop_timer_running(a->timer)) {
+            if (ignore_delay) {
+                /* 'refresh' forces a write of the current value of all attributes
+                 * Cancel any existing timers, we're writing it NOW
+                 */
+                mainloop_timer_stop(a->timer);
+                crm_debug("Write out of '%s': timer is running but ignore delay", a->id);
+            } else {
+                crm_info("Write out of '%s' delayed: timer is running", a->id);
+                return;
+            }
+        }
+
+        /* Values are gathered when the write is actually sent, so changes
+         * made before then will be included
+         */
+        if (pending_writes == NULL) {
+            pending_writes = pcmk__strkey_table(free, NULL);
+        }
+        if (write_trigger == NULL) {
+            write_trigger = mainloop_add_trigger(G_PRIORITY_LOW,
+                                                 write_pending_attributes,
+                                                 NULL);
+        }
+        if (!g_hash_table_contains(pending_writes, a->id)) {
+            crm_trace("Queueing write of %s", a->id);
+            g_hash_table_add(pending_writes, strdup(a->id));
+        }
+        mainloop_set_trigger(write_trigger);
+        return;
+    }
+
+    add_attribute_values(a, NULL, NULL, NULL);
+}
@@ -214,6 +214,7 @@ void
 attrd_cib_disconnect()
 {
     CRM_CHECK(the_cib != NULL, return);
+    attrd_flush_pending_writes();
     the_cib->cmds->del_notify_callback(the_cib, T_CIB_REPLACE_NOTIFY, attrd_cib_replaced_cb);
     the_cib->cmds->del_notify_callback(the_cib, T_CIB_DIFF_NOTIFY, attrd_cib_updated_cb);
     cib__clean_up_connection(&the_cib);
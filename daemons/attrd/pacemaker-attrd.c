@@ -204,6 +204,19 @@ attrd_cib_connect(int max_retry)
         goto cleanup;
     }
 
+    /* Diffs are only used to notice alert changes, so skip the status updates
+     * that make up most of them. An older CIB manager rejects the filter and
+     * sends every diff, which is harmless.
+     */
+    rc = the_cib->cmds->set_diff_filter(the_cib,
+                                        "/" XML_TAG_CIB
+                                        "/" XML_CIB_TAG_CONFIGURATION
+                                        "/" XML_CIB_TAG_ALERTS, 1);
+    if (rc != pcmk_ok) {
+        crm_debug("Could not filter CIB diff notifications: %s "
+                  CRM_XS " rc=%d", pcmk_strerror(rc), rc);
+    }
+
     return pcmk_ok;
 
   cleanup:
@@ -101,6 +101,9 @@ typedef struct attribute_s {
 
     gboolean force_write; /* Flag for updating attribute by ignoring delay */
 
+    gboolean write_alone; /* whether to write in its own CIB request (after a
+                           * combined write failed) */
+
 } attribute_t;
 
 typedef struct attribute_value_s {
@@ -121,6 +124,7 @@ extern GHashTable *attributes;
 #define CIB_OP_TIMEOUT_S 120
 
 void write_attributes(bool all, bool ignore_delay);
+void attrd_flush_pending_writes(void);
 void attrd_broadcast_protocol(void);
 void attrd_peer_message(crm_node_t *client, xmlNode *msg);
 void attrd_client_peer_remove(pcmk__client_t *client, xmlNode *xml);
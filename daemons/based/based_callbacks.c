@@ -109,6 +109,7 @@ cib_ipc_closed(qb_ipcs_connection_t * c)
         return 0;
     }
     crm_trace("Connection %p", c);
+    cib_free_diff_filters(client);
     pcmk__free_client(client);
     return 0;
 }
@@ -184,6 +185,16 @@ cib_common_callback_worker(uint32_t id, uint32_t flags, xmlNode * op_request,
         } else if (pcmk__str_eq(type, T_CIB_REPLACE_NOTIFY, pcmk__str_casei)) {
             bit = cib_notify_replace;
 
+        } else if (pcmk__str_eq(type, T_CIB_DIFF_FILTER, pcmk__str_casei)) {
+            const char *path = crm_element_value(op_request,
+                                                 F_CIB_NOTIFY_PATH);
+
+            if (path == NULL) {
+                status = CRM_EX_INVALID_PARAM;
+            } else {
+                cib_set_diff_filter(cib_client, path, on_off);
+            }
+
         } else {
             status = CRM_EX_INVALID_PARAM;
         }
@@ -336,7 +347,7 @@ process_ping_reply(xmlNode *reply)
 
         if(ping_digest == NULL) {
             crm_trace("Calculating new digest");
-            ping_digest = calculate_xml_versioned_digest(the_cib, FALSE, TRUE, version);
+            ping_digest = cib_current_digest(version);
         }
 
         crm_trace("Processing ping reply %s from %s (%s)", seq_s, host, digest);
@@ -1178,6 +1189,136 @@ calculate_section_digest(const char *xpath, xmlNode * xml_obj)
 
 }
 
+/* Sections whose replacement triggers a refresh notification, along with the
+ * digest of each in the_cib (if calculated since the CIB last changed)
+ */
+static struct {
+    int section;
+    const char *xpath;
+    char *digest;
+} section_digests[] = {
+    {
+        cib_change_section_nodes,
+        "//" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION "/" XML_CIB_TAG_NODES,
+        NULL
+    },
+    {
+        cib_change_section_alerts,
+        "//" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION "/" XML_CIB_TAG_ALERTS,
+        NULL
+    },
+    {
+        cib_change_section_status,
+        "//" XML_TAG_CIB "/" XML_CIB_TAG_STATUS,
+        NULL
+    },
+};
+
+#define N_SECTION_DIGESTS \
+    ((int) (sizeof(section_digests) / sizeof(section_digests[0])))
+
+// Digest of the_cib as a whole (if calculated since the CIB last changed)
+static char *cib_digest = NULL;
+
+/*!
+ * \internal
+ * \brief Discard any cached digests of the current CIB
+ *
+ * \note This must be called whenever the_cib is replaced or modified in place.
+ */
+void
+cib_forget_digests(void)
+{
+    free(cib_digest);
+    cib_digest = NULL;
+    for (int i = 0; i < N_SECTION_DIGESTS; i++) {
+        free(section_digests[i].digest);
+        section_digests[i].digest = NULL;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Get the digest of the current CIB
+ *
+ * \param[in] version  CRM feature set of the peer the digest is for
+ *
+ * \return Newly allocated digest of the_cib
+ * \note The digest is calculated at most once per CIB change for any peer
+ *       using the current digest algorithm.
+ */
+char *
+cib_current_digest(const char *version)
+{
+    if ((version == NULL) || (compare_version("3.0.5", version) > 0)) {
+        // Old peers use a different algorithm, so don't bother caching
+        return calculate_xml_versioned_digest(the_cib, FALSE, TRUE, version);
+    }
+    if (cib_digest == NULL) {
+        cib_digest = calculate_xml_versioned_digest(the_cib, FALSE, TRUE,
+                                                    CRM_FEATURE_SET);
+    }
+    return strdup(cib_digest);
+}
+
+/*!
+ * \internal
+ * \brief Take ownership of the section digests of the current CIB
+ *
+ * \param[out] digests  Where to store digests (calculating any not yet known)
+ */
+static void
+take_section_digests(char **digests)
+{
+    for (int i = 0; i < N_SECTION_DIGESTS; i++) {
+        digests[i] = section_digests[i].digest;
+        section_digests[i].digest = NULL;
+        if (digests[i] == NULL) {
+            digests[i] = calculate_section_digest(section_digests[i].xpath,
+                                                  the_cib);
+        }
+    }
+    crm_trace("current-digest %s:%s:%s", digests[0], digests[1], digests[2]);
+}
+
+/*!
+ * \internal
+ * \brief Determine which sections a replace operation changed
+ *
+ * \param[in] digests     Section digests from before the replace operation
+ * \param[in] result_cib  CIB resulting from the replace operation
+ *
+ * \return Group of enum cib_change_section_info flags
+ * \note If result_cib has become the_cib, its section digests are kept for the
+ *       next replace operation.
+ */
+static int
+replaced_sections(char **digests, xmlNode *result_cib)
+{
+    int change_section = cib_change_section_none;
+    char *result_digests[N_SECTION_DIGESTS];
+
+    for (int i = 0; i < N_SECTION_DIGESTS; i++) {
+        result_digests[i] = calculate_section_digest(section_digests[i].xpath,
+                                                     result_cib);
+        if (!pcmk__str_eq(digests[i], result_digests[i], pcmk__str_none)) {
+            change_section |= section_digests[i].section;
+        }
+    }
+    crm_trace("result-digest %s:%s:%s",
+              result_digests[0], result_digests[1], result_digests[2]);
+
+    cib_forget_digests();
+    for (int i = 0; i < N_SECTION_DIGESTS; i++) {
+        if (result_cib == the_cib) {
+            section_digests[i].digest = result_digests[i];
+        } else {
+            free(result_digests[i]);
+        }
+    }
+    return change_section;
+}
+
 static int
 cib_process_command(xmlNode * request, xmlNode ** reply, xmlNode ** cib_diff, gboolean privileged)
 {
@@ -1203,9 +1344,7 @@ cib_process_command(xmlNode * request, xmlNode ** reply, xmlNode ** cib_diff, gb
 
     static mainloop_timer_t *digest_timer = NULL;
 
-    char *current_nodes_digest = NULL;
-    char *current_alerts_digest = NULL;
-    char *current_status_digest = NULL;
+    char *current_digests[N_SECTION_DIGESTS] = { NULL, };
     int change_section = cib_change_section_nodes | cib_change_section_alerts | cib_change_section_status;
 
     CRM_ASSERT(cib_status == pcmk_ok);
@@ -1264,7 +1403,12 @@ cib_process_command(xmlNode * request, xmlNode ** reply, xmlNode ** cib_diff, gb
             manage_counters = FALSE;
         }
 
+        /* A transaction can fail after some of its requests have been
+         * applied, and those can't be backed out of the live CIB, so it always
+         * works on a copy.
+         */
         if (!pcmk_is_set(call_options, cib_dryrun)
+            && !pcmk__str_eq(op, CIB_OP_TRANSACTION, pcmk__str_none)
             && pcmk__str_eq(section, XML_CIB_TAG_STATUS, pcmk__str_casei)) {
             /* Copying large CIBs accounts for a huge percentage of our CIB usage */
             cib__set_call_options(call_options, "call", cib_zero_copy);
@@ -1274,10 +1418,7 @@ cib_process_command(xmlNode * request, xmlNode ** reply, xmlNode ** cib_diff, gb
 
         /* Calculate the hash value of the section before the change. */
         if (pcmk__str_eq(CIB_OP_REPLACE, op, pcmk__str_none)) {
-            current_nodes_digest = calculate_section_digest("//" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION "/" XML_CIB_TAG_NODES, current_cib);
-            current_alerts_digest = calculate_section_digest("//" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION "/" XML_CIB_TAG_ALERTS, current_cib);
-            current_status_digest = calculate_section_digest("//" XML_TAG_CIB "/" XML_CIB_TAG_STATUS, current_cib);
-            crm_trace("current-digest %s:%s:%s", current_nodes_digest, current_alerts_digest, current_status_digest);
+            take_section_digests(current_digests);
         }
 
         /* result_cib must not be modified after cib_perform_op() returns */
@@ -1285,6 +1426,11 @@ cib_process_command(xmlNode * request, xmlNode ** reply, xmlNode ** cib_diff, gb
                             section, request, input, manage_counters, &config_changed,
                             current_cib, &result_cib, cib_diff, &output);
 
+        if (pcmk_is_set(call_options, cib_zero_copy)) {
+            // the_cib may have been modified in place
+            cib_forget_digests();
+        }
+
         if (manage_counters == FALSE) {
             int format = 1;
             /* Legacy code
@@ -1324,33 +1470,11 @@ cib_process_command(xmlNode * request, xmlNode ** reply, xmlNode ** cib_diff, gb
         }
 
         if (pcmk__str_eq(CIB_OP_REPLACE, op, pcmk__str_none)) {
-            char *result_nodes_digest = NULL;
-            char *result_alerts_digest = NULL;
-            char *result_status_digest = NULL;
-
             /* Calculate the hash value of the changed section. */
-            result_nodes_digest = calculate_section_digest("//" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION "/" XML_CIB_TAG_NODES, result_cib);
-            result_alerts_digest = calculate_section_digest("//" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION "/" XML_CIB_TAG_ALERTS, result_cib);
-            result_status_digest = calculate_section_digest("//" XML_TAG_CIB "/" XML_CIB_TAG_STATUS, result_cib);
-            crm_trace("result-digest %s:%s:%s", result_nodes_digest, result_alerts_digest, result_status_digest);
-
-            if (pcmk__str_eq(current_nodes_digest, result_nodes_digest, pcmk__str_none)) {
-                change_section = change_section ^ cib_change_section_nodes;
-            }
-            if (pcmk__str_eq(current_alerts_digest, result_alerts_digest, pcmk__str_none)) {
-                change_section = change_section ^ cib_change_section_alerts;
-            }
-            if (pcmk__str_eq(current_status_digest, result_status_digest, pcmk__str_none)) {
-                change_section = change_section ^ cib_change_section_status;
-            }
-
+            change_section = replaced_sections(current_digests, result_cib);
             if (change_section) {
                 send_r_notify = TRUE;
             }
-            
-            free(result_nodes_digest);
-            free(result_alerts_digest);
-            free(result_status_digest);
 
         } else if (pcmk__str_eq(CIB_OP_ERASE, op, pcmk__str_none)) {
             send_r_notify = TRUE;
@@ -1424,9 +1548,9 @@ cib_process_command(xmlNode * request, xmlNode ** reply, xmlNode ** cib_diff, gb
         cib_op_cleanup(call_type, call_options, &input, &output);
     }
 
-    free(current_nodes_digest);
-    free(current_alerts_digest);
-    free(current_status_digest);
+    for (int i = 0; i < N_SECTION_DIGESTS; i++) {
+        free(current_digests[i]);
+    }
 
     crm_trace("done");
     return rc;
@@ -161,6 +161,7 @@ static cib_operation_t cib_server_ops[] = {
     {CIB_OP_ISMASTER,  FALSE, TRUE,  FALSE, cib_prepare_none, cib_cleanup_none,   cib_process_readwrite},
     {"cib_shutdown_req",FALSE, TRUE, FALSE, cib_prepare_sync, cib_cleanup_none,   cib_process_shutdown_req},
     {CRM_OP_PING,      FALSE, FALSE, FALSE, cib_prepare_none, cib_cleanup_output, cib_process_ping},
+    {CIB_OP_TRANSACTION, TRUE, TRUE, TRUE,  cib_prepare_data, cib_cleanup_data,   cib_process_transaction},
 };
 
 int
@@ -226,7 +227,8 @@ cib_msg_copy(xmlNode * msg, gboolean with_data)
         F_CIB_CLIENTNAME,
         F_CIB_USER,
         F_CIB_NOTIFY_TYPE,
-        F_CIB_NOTIFY_ACTIVATE
+        F_CIB_NOTIFY_ACTIVATE,
+        F_CIB_NOTIFY_PATH
     };
 
     static const char *data_list[] = {
@@ -328,6 +328,7 @@ uninitializeCib(void)
     }
 
     the_cib = NULL;
+    cib_forget_digests();
 
     crm_debug("Deallocating the CIB.");
 
@@ -351,6 +352,7 @@ activateCibXml(xmlNode * new_cib, gboolean to_disk, const char *op)
         CRM_ASSERT(new_cib != saved_cib);
         the_cib = new_cib;
         free_xml(saved_cib);
+        cib_forget_digests();
         if (cib_writes_enabled && cib_status == pcmk_ok && to_disk) {
             crm_debug("Triggering CIB write for %s op", op);
             mainloop_set_trigger(cib_writer);
@@ -157,7 +157,7 @@ cib_process_ping(const char *op, int options, const char *section, xmlNode * req
 {
     const char *host = crm_element_value(req, F_ORIG);
     const char *seq = crm_element_value(req, F_CIB_PING_ID);
-    char *digest = calculate_xml_versioned_digest(the_cib, FALSE, TRUE, CRM_FEATURE_SET);
+    char *digest = cib_current_digest(CRM_FEATURE_SET);
 
     static struct qb_log_callsite *cs = NULL;
 
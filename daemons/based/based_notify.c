@@ -33,16 +33,150 @@ int pending_updates = 0;
 
 struct cib_notification_s {
     xmlNode *msg;
+    xmlNode *diff;      // Patchset, if this is a diff notification
     struct iovec *iov;
     int32_t iov_size;
 };
 
+/* Paths that clients have limited their diff notifications to (as GLists of
+ * strings), indexed by client ID. Most clients don't set any.
+ */
+static GHashTable *diff_filters = NULL;
+
 void attach_cib_generation(xmlNode * msg, const char *field, xmlNode * a_cib);
 
 static void do_cib_notify(int options, const char *op, xmlNode *update,
                           int result, xmlNode * result_data,
                           const char *msg_type);
 
+/*!
+ * \internal
+ * \brief Add or remove a path that a client's diff notifications are limited to
+ *
+ * \param[in] client  Client to update
+ * \param[in] path    Absolute CIB path, in the form used by patchset changes
+ * \param[in] enable  Whether to add (rather than remove) \p path
+ */
+void
+cib_set_diff_filter(pcmk__client_t *client, const char *path, bool enable)
+{
+    GList *filters = NULL;
+    GList *existing = NULL;
+
+    if (diff_filters == NULL) {
+        diff_filters = pcmk__strkey_table(free, NULL);
+    }
+    filters = g_hash_table_lookup(diff_filters, client->id);
+    existing = g_list_find_custom(filters, path, (GCompareFunc) strcmp);
+
+    crm_debug("%s diff notification filter %s for client %s",
+              (enable? "Adding" : "Removing"), path,
+              pcmk__client_name(client));
+
+    if (enable && (existing == NULL)) {
+        filters = g_list_prepend(filters, strdup(path));
+
+    } else if (!enable && (existing != NULL)) {
+        free(existing->data);
+        filters = g_list_delete_link(filters, existing);
+    }
+
+    // The table doesn't own its values, so this won't free the list
+    if (filters == NULL) {
+        g_hash_table_remove(diff_filters, client->id);
+    } else {
+        g_hash_table_insert(diff_filters, strdup(client->id), filters);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Free any diff notification filters set by a client
+ *
+ * \param[in] client  Client being freed
+ */
+void
+cib_free_diff_filters(pcmk__client_t *client)
+{
+    GList *filters = NULL;
+
+    if ((diff_filters == NULL) || (client == NULL) || (client->id == NULL)) {
+        return;
+    }
+    filters = g_hash_table_lookup(diff_filters, client->id);
+    if (filters != NULL) {
+        g_hash_table_remove(diff_filters, client->id);
+        g_list_free_full(filters, free);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Check whether a patchset change could affect a filtered CIB element
+ *
+ * \param[in] change  Change from v2 patchset
+ * \param[in] filter  Path of CIB element of interest
+ *
+ * \return true if \p change could affect \p filter or anything within it
+ * \note A step of \p filter without an ID predicate matches elements of that
+ *       name with any ID.
+ */
+static bool
+change_matches_filter(xmlNode *change, const char *filter)
+{
+    const char *op = crm_element_value(change, XML_DIFF_OP);
+    const char *path = crm_element_value(change, XML_DIFF_PATH);
+
+    if (path == NULL) {
+        return true; // Shouldn't be possible, but err on the side of sending
+    }
+    if (pcmk__xpath_within(path, filter)) {
+        return true;
+    }
+
+    /* A created element's path is that of its parent, so anything created
+     * above the filtered element might contain it, and anything deleted above
+     * it removes it. A modified or moved ancestor doesn't affect it.
+     */
+    return pcmk__str_any_of(op, "create", "delete", NULL)
+           && pcmk__xpath_within(filter, path);
+}
+
+// Whether a client wants a given diff notification, according to its filters
+static bool
+diff_wanted(pcmk__client_t *client, xmlNode *diff)
+{
+    GList *filters = NULL;
+    int format = 1;
+
+    if ((diff_filters == NULL) || (diff == NULL)) {
+        return true;
+    }
+    filters = g_hash_table_lookup(diff_filters, client->id);
+    if (filters == NULL) {
+        return true;
+    }
+
+    // Only v2 patchsets describe changes by path
+    crm_element_value_int(diff, "format", &format);
+    if (format != 2) {
+        return true;
+    }
+
+    for (xmlNode *change = first_named_child(diff, XML_DIFF_CHANGE);
+         change != NULL; change = crm_next_same_xml(change)) {
+
+        for (GList *iter = filters; iter != NULL; iter = iter->next) {
+            if (change_matches_filter(change, (const char *) iter->data)) {
+                return true;
+            }
+        }
+    }
+    crm_trace("Skipping diff notification for client %s: "
+              "no changes match its filters", pcmk__client_name(client));
+    return false;
+}
+
 static void
 cib_notify_send_one(gpointer key, gpointer value, gpointer user_data)
 {
@@ -64,7 +198,7 @@ cib_notify_send_one(gpointer key, gpointer value, gpointer user_data)
     if (pcmk_is_set(client->flags, cib_notify_diff)
         && pcmk__str_eq(type, T_CIB_DIFF_NOTIFY, pcmk__str_casei)) {
 
-        do_send = TRUE;
+        do_send = diff_wanted(client, update->diff);
 
     } else if (pcmk_is_set(client->flags, cib_notify_replace)
                && pcmk__str_eq(type, T_CIB_REPLACE_NOTIFY, pcmk__str_casei)) {
@@ -112,7 +246,7 @@ cib_notify_send_one(gpointer key, gpointer value, gpointer user_data)
 }
 
 static void
-cib_notify_send(xmlNode * xml)
+cib_notify_send(xmlNode *xml, xmlNode *diff)
 {
     struct iovec *iov;
     struct cib_notification_s update;
@@ -122,6 +256,7 @@ cib_notify_send(xmlNode * xml)
 
     if (rc == pcmk_rc_ok) {
         update.msg = xml;
+        update.diff = diff;
         update.iov = iov;
         update.iov_size = bytes;
         pcmk__foreach_ipc_client(cib_notify_send_one, &update);
@@ -217,7 +352,9 @@ do_cib_notify(int options, const char *op, xmlNode * update,
         add_message_xml(update_msg, F_CIB_UPDATE_RESULT, result_data);
     }
 
-    cib_notify_send(update_msg);
+    cib_notify_send(update_msg,
+                    pcmk__str_eq(msg_type, T_CIB_DIFF_NOTIFY, pcmk__str_none)?
+                    result_data : NULL);
     free_xml(update_msg);
 }
 
@@ -276,6 +413,6 @@ cib_replace_notify(const char *origin, xmlNode * update, int result, xmlNode * d
 
     crm_log_xml_trace(replace_msg, "CIB Replaced");
 
-    cib_notify_send(replace_msg);
+    cib_notify_send(replace_msg, NULL);
     free_xml(replace_msg);
 }
@@ -395,6 +395,7 @@ cib_remote_connection_destroy(gpointer user_data)
         close(csock);
     }
 
+    cib_free_diff_filters(client);
     pcmk__free_client(client);
 
     crm_trace("Freed the cib client");
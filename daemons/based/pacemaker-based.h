@@ -148,6 +148,11 @@ void cib_diff_notify(int options, const char *client, const char *call_id,
                      xmlNode *old_cib);
 void cib_replace_notify(const char *origin, xmlNode *update, int result,
                         xmlNode *diff, int change_section);
+void cib_set_diff_filter(pcmk__client_t *client, const char *path,
+                         bool enable);
+void cib_free_diff_filters(pcmk__client_t *client);
+char *cib_current_digest(const char *version);
+void cib_forget_digests(void);
 
 static inline const char *
 cib_config_lookup(const char *opt)
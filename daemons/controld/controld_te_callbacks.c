@@ -252,105 +252,60 @@ process_resource_updates(const char *node, xmlNode *xml, xmlNode *change,
     }
 }
 
-static char *extract_node_uuid(const char *xpath) 
-{
-    char *mutable_path = strdup(xpath);
-    char *node_uuid = NULL;
-    char *search = NULL;
-    char *match = NULL;
-
-    match = strstr(mutable_path, "node_state[@id=\'");
-    if (match == NULL) {
-        free(mutable_path);
-        return NULL;
-    }
-    match += strlen("node_state[@id=\'");
-
-    search = strchr(match, '\'');
-    if (search == NULL) {
-        free(mutable_path);
-        return NULL;
-    }
-    search[0] = 0;
-
-    node_uuid = strdup(match);
-    free(mutable_path);
-    return node_uuid;
-}
-
 static void
-abort_unless_down(const char *xpath, const char *op, xmlNode *change,
-                  const char *reason)
+abort_unless_down(const pcmk__patch_change_t *change, const char *reason)
 {
-    char *node_uuid = NULL;
+    const char *node_uuid = NULL;
     crm_action_t *down = NULL;
 
-    if(!pcmk__str_eq(op, "delete", pcmk__str_casei)) {
-        abort_transition(INFINITY, tg_restart, reason, change);
+    if (change->op != pcmk__patch_op_delete) {
+        abort_transition(INFINITY, tg_restart, reason, change->change);
         return;
     }
 
-    node_uuid = extract_node_uuid(xpath);
+    node_uuid = pcmk__patch_change_id(change, XML_CIB_TAG_STATE);
     if(node_uuid == NULL) {
-        crm_err("Could not extract node ID from %s", xpath);
-        abort_transition(INFINITY, tg_restart, reason, change);
+        crm_err("Could not extract node ID from %s", change->path);
+        abort_transition(INFINITY, tg_restart, reason, change->change);
         return;
     }
 
     down = match_down_event(node_uuid);
     if (down == NULL) {
-        crm_trace("Not expecting %s to be down (%s)", node_uuid, xpath);
-        abort_transition(INFINITY, tg_restart, reason, change);
+        crm_trace("Not expecting %s to be down (%s)", node_uuid, change->path);
+        abort_transition(INFINITY, tg_restart, reason, change->change);
     } else {
-        crm_trace("Expecting changes to %s (%s)", node_uuid, xpath);
+        crm_trace("Expecting changes to %s (%s)", node_uuid, change->path);
     }
-    free(node_uuid);
 }
 
 static void
-process_op_deletion(const char *xpath, xmlNode *change)
+process_op_deletion(const pcmk__patch_change_t *change, const char *key)
 {
-    char *mutable_key = strdup(xpath);
-    char *key;
-    char *node_uuid;
+    const char *node_uuid = pcmk__patch_change_id(change, XML_CIB_TAG_STATE);
 
-    // Extract the part of xpath between last pair of single quotes
-    key = strrchr(mutable_key, '\'');
-    if (key != NULL) {
-        *key = '\0';
-        key = strrchr(mutable_key, '\'');
-    }
-    if (key == NULL) {
-        crm_warn("Ignoring malformed CIB update (resource deletion of %s)",
-                 xpath);
-        free(mutable_key);
-        return;
-    }
-    ++key;
-
-    node_uuid = extract_node_uuid(xpath);
     if (confirm_cancel_action(key, node_uuid) == FALSE) {
         abort_transition(INFINITY, tg_restart, "Resource operation removal",
-                         change);
+                         change->change);
     }
-    free(mutable_key);
-    free(node_uuid);
 }
 
 static void
-process_delete_diff(const char *xpath, const char *op, xmlNode *change)
+process_delete_diff(const pcmk__patch_change_t *change)
 {
-    if (strstr(xpath, "/" XML_LRM_TAG_RSC_OP "[")) {
-        process_op_deletion(xpath, change);
+    const char *key = pcmk__patch_change_id(change, XML_LRM_TAG_RSC_OP);
 
-    } else if (strstr(xpath, "/" XML_CIB_TAG_LRM "[")) {
-        abort_unless_down(xpath, op, change, "Resource state removal");
+    if (key != NULL) {
+        process_op_deletion(change, key);
 
-    } else if (strstr(xpath, "/" XML_CIB_TAG_STATE "[")) {
-        abort_unless_down(xpath, op, change, "Node state removal");
+    } else if (pcmk__patch_change_id(change, XML_CIB_TAG_LRM) != NULL) {
+        abort_unless_down(change, "Resource state removal");
+
+    } else if (pcmk__patch_change_id(change, XML_CIB_TAG_STATE) != NULL) {
+        abort_unless_down(change, "Node state removal");
 
     } else {
-        crm_trace("Ignoring delete of %s", xpath);
+        crm_trace("Ignoring delete of %s", change->path);
     }
 }
 
@@ -389,48 +344,62 @@ process_cib_diff(xmlNode *cib, xmlNode *change, const char *op,
     }
 }
 
+/*!
+ * \internal
+ * \brief Check whether a patchset change is in the CIB configuration section
+ *
+ * \param[in] change  Parsed patchset change
+ *
+ * \return true if \p change's path is in the configuration, otherwise false
+ */
+static bool
+change_in_config(const pcmk__patch_change_t *change)
+{
+    return (change->n_steps >= 2)
+           && (strcmp(change->steps[0].tag, XML_TAG_CIB) == 0)
+           && (strcmp(change->steps[1].tag, XML_CIB_TAG_CONFIGURATION) == 0);
+}
+
 static void
 te_update_diff_v2(xmlNode *diff)
 {
+    pcmk__patch_change_t *changes = NULL;
+    int n_changes = 0;
+
     crm_log_xml_trace(diff, "Patch:Raw");
 
-    for (xmlNode *change = pcmk__xml_first_child(diff); change != NULL;
-         change = pcmk__xml_next(change)) {
+    if (pcmk__patchset_changes(diff, &changes, &n_changes) != pcmk_rc_ok) {
+        crm_warn("Ignoring malformed CIB update (could not parse patchset)");
+        return;
+    }
 
-        xmlNode *match = NULL;
+    for (int i = 0; i < n_changes; i++) {
+        const pcmk__patch_change_t *change = &(changes[i]);
+        xmlNode *match = change->result;
         const char *name = NULL;
-        const char *xpath = crm_element_value(change, XML_DIFF_PATH);
-
-        // Possible ops: create, modify, delete, move
-        const char *op = crm_element_value(change, XML_DIFF_OP);
+        const char *xpath = change->path;
+        const char *op = change->op_name;
 
         // Ignore uninteresting updates
-        if (op == NULL) {
-            continue;
-
-        } else if (xpath == NULL) {
+        if (xpath == NULL) {
             crm_trace("Ignoring %s change for version field", op);
             continue;
 
-        } else if (strcmp(op, "move") == 0) {
+        } else if (change->op == pcmk__patch_op_move) {
             crm_trace("Ignoring move change at %s", xpath);
             continue;
-        }
-
-        // Find the result of create/modify ops
-        if (strcmp(op, "create") == 0) {
-            match = change->children;
 
-        } else if (strcmp(op, "modify") == 0) {
-            match = first_named_child(change, XML_DIFF_RESULT);
-            if(match) {
-                match = match->children;
-            }
-
-        } else if (strcmp(op, "delete") != 0) {
+        } else if (change->op == pcmk__patch_op_unknown) {
             crm_warn("Ignoring malformed CIB update (%s operation on %s is unrecognized)",
                      op, xpath);
             continue;
+
+        } else if (change->n_steps == 0) {
+            // We can't tell what changed, so play it safe
+            crm_warn("Unrecognized CIB change path %s", xpath);
+            abort_transition(INFINITY, tg_restart, "Unrecognized change",
+                             change->change);
+            break;
         }
 
         if (match) {
@@ -445,63 +414,63 @@ te_update_diff_v2(xmlNode *diff)
                   op, (xpath? xpath : "CIB"),
                   (name? " matched by " : ""), (name? name : ""));
 
-        if (strstr(xpath, "/" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION)) {
+        if (change_in_config(change)) {
             abort_transition(INFINITY, tg_restart, "Configuration change",
-                             change);
+                             change->change);
             break; // Won't be packaged with operation results we may be waiting for
 
-        } else if (strstr(xpath, "/" XML_CIB_TAG_TICKETS)
+        } else if ((pcmk__patch_change_step(change, XML_CIB_TAG_TICKETS) != NULL)
                    || pcmk__str_eq(name, XML_CIB_TAG_TICKETS, pcmk__str_casei)) {
-            abort_transition(INFINITY, tg_restart, "Ticket attribute change", change);
+            abort_transition(INFINITY, tg_restart, "Ticket attribute change",
+                             change->change);
             break; // Won't be packaged with operation results we may be waiting for
 
-        } else if (strstr(xpath, "/" XML_TAG_TRANSIENT_NODEATTRS "[")
+        } else if ((pcmk__patch_change_id(change,
+                                          XML_TAG_TRANSIENT_NODEATTRS) != NULL)
                    || pcmk__str_eq(name, XML_TAG_TRANSIENT_NODEATTRS, pcmk__str_casei)) {
-            abort_unless_down(xpath, op, change, "Transient attribute change");
+            abort_unless_down(change, "Transient attribute change");
             break; // Won't be packaged with operation results we may be waiting for
 
-        } else if (strcmp(op, "delete") == 0) {
-            process_delete_diff(xpath, op, change);
+        } else if (change->op == pcmk__patch_op_delete) {
+            process_delete_diff(change);
 
         } else if (name == NULL) {
             crm_warn("Ignoring malformed CIB update (%s at %s has no result)",
                      op, xpath);
 
         } else if (strcmp(name, XML_TAG_CIB) == 0) {
-            process_cib_diff(match, change, op, xpath);
+            process_cib_diff(match, change->change, op, xpath);
 
         } else if (strcmp(name, XML_CIB_TAG_STATUS) == 0) {
-            process_status_diff(match, change, op, xpath);
+            process_status_diff(match, change->change, op, xpath);
 
         } else if (strcmp(name, XML_CIB_TAG_STATE) == 0) {
-            process_node_state_diff(match, change, op, xpath);
+            process_node_state_diff(match, change->change, op, xpath);
 
         } else if (strcmp(name, XML_CIB_TAG_LRM) == 0) {
-            process_resource_updates(ID(match), match, change, op, xpath);
+            process_resource_updates(ID(match), match, change->change, op,
+                                     xpath);
 
         } else if (strcmp(name, XML_LRM_TAG_RESOURCES) == 0) {
-            char *local_node = pcmk__xpath_node_id(xpath, "lrm");
-
-            process_resource_updates(local_node, match, change, op, xpath);
-            free(local_node);
+            process_resource_updates(pcmk__patch_change_id(change,
+                                                           XML_CIB_TAG_LRM),
+                                     match, change->change, op, xpath);
 
         } else if (strcmp(name, XML_LRM_TAG_RESOURCE) == 0) {
-            char *local_node = pcmk__xpath_node_id(xpath, "lrm");
-
-            process_lrm_resource_diff(match, local_node);
-            free(local_node);
+            process_lrm_resource_diff(match,
+                                      pcmk__patch_change_id(change,
+                                                            XML_CIB_TAG_LRM));
 
         } else if (strcmp(name, XML_LRM_TAG_RSC_OP) == 0) {
-            char *local_node = pcmk__xpath_node_id(xpath, "lrm");
-
-            process_graph_event(match, local_node);
-            free(local_node);
+            process_graph_event(match,
+                                pcmk__patch_change_id(change, XML_CIB_TAG_LRM));
 
         } else {
             crm_warn("Ignoring malformed CIB update (%s at %s has unrecognized result %s)",
                      op, xpath, name);
         }
     }
+    pcmk__free_patchset_changes(changes, n_changes);
 }
 
 void
@@ -199,56 +199,31 @@ update_failcount(xmlNode * event, const char *event_node_uuid, int rc,
 crm_action_t *
 controld_get_action(int id)
 {
-    for (GList *item = transition_graph->synapses; item; item = item->next) {
-        synapse_t *synapse = (synapse_t *) item->data;
-
-        for (GList *item2 = synapse->actions; item2; item2 = item2->next) {
-            crm_action_t *action = (crm_action_t *) item2->data;
-
-            if (action->id == id) {
-                return action;
-            }
-        }
-    }
-    return NULL;
+    return g_hash_table_lookup(transition_graph->actions_by_id,
+                               GINT_TO_POINTER(id));
 }
 
 crm_action_t *
 get_cancel_action(const char *id, const char *node)
 {
-    GList *gIter = NULL;
-    GList *gIter2 = NULL;
+    GList *cancels = NULL;
 
-    gIter = transition_graph->synapses;
-    for (; gIter != NULL; gIter = gIter->next) {
-        synapse_t *synapse = (synapse_t *) gIter->data;
-
-        gIter2 = synapse->actions;
-        for (; gIter2 != NULL; gIter2 = gIter2->next) {
-            const char *task = NULL;
-            const char *target = NULL;
-            crm_action_t *action = (crm_action_t *) gIter2->data;
-
-            task = crm_element_value(action->xml, XML_LRM_ATTR_TASK);
-            if (!pcmk__str_eq(CRMD_ACTION_CANCEL, task, pcmk__str_casei)) {
-                continue;
-            }
-
-            task = crm_element_value(action->xml, XML_LRM_ATTR_TASK_KEY);
-            if (!pcmk__str_eq(task, id, pcmk__str_casei)) {
-                crm_trace("Wrong key %s for %s on %s", task, id, node);
-                continue;
-            }
+    if (id != NULL) {
+        cancels = g_hash_table_lookup(transition_graph->cancels_by_key, id);
+    }
 
-            target = crm_element_value(action->xml, XML_LRM_ATTR_TARGET_UUID);
-            if (node && !pcmk__str_eq(target, node, pcmk__str_casei)) {
-                crm_trace("Wrong node %s for %s on %s", target, id, node);
-                continue;
-            }
+    for (GList *iter = cancels; iter != NULL; iter = iter->next) {
+        crm_action_t *action = (crm_action_t *) iter->data;
+        const char *target = crm_element_value(action->xml,
+                                               XML_LRM_ATTR_TARGET_UUID);
 
-            crm_trace("Found %s on %s", id, node);
-            return action;
+        if (node && !pcmk__str_eq(target, node, pcmk__str_casei)) {
+            crm_trace("Wrong node %s for %s on %s", target, id, node);
+            continue;
         }
+
+        crm_trace("Found %s on %s", id, node);
+        return action;
     }
 
     return NULL;
@@ -275,50 +250,36 @@ confirm_cancel_action(const char *id, const char *node_id)
     return TRUE;
 }
 
-/* downed nodes are listed like: <downed> <node id="UUID1" /> ... </downed> */
-#define XPATH_DOWNED "//" XML_GRAPH_TAG_DOWNED \
-                     "/" XML_CIB_TAG_NODE "[@" XML_ATTR_UUID "='%s']"
-
 /*!
  * \brief Find a transition event that would have made a specified node down
  *
  * \param[in] target  UUID of node to match
  *
  * \return Matching event if found, NULL otherwise
+ * \note Downed nodes are listed in actions like:
+ *       <downed> <node id="UUID1" /> ... </downed>
  */
 crm_action_t *
 match_down_event(const char *target)
 {
     crm_action_t *match = NULL;
-    xmlXPathObjectPtr xpath_ret = NULL;
-    GList *gIter, *gIter2;
+    GList *candidates = NULL;
 
-    char *xpath = crm_strdup_printf(XPATH_DOWNED, target);
-
-    for (gIter = transition_graph->synapses;
-         gIter != NULL && match == NULL;
-         gIter = gIter->next) {
+    if (target != NULL) {
+        candidates = g_hash_table_lookup(transition_graph->downed_by_node,
+                                         target);
+    }
 
-        for (gIter2 = ((synapse_t*)gIter->data)->actions;
-             gIter2 != NULL && match == NULL;
-             gIter2 = gIter2->next) {
+    for (GList *iter = candidates; iter != NULL; iter = iter->next) {
+        crm_action_t *action = (crm_action_t *) iter->data;
 
-            match = (crm_action_t*)gIter2->data;
-            if (pcmk_is_set(match->flags, pcmk__graph_action_executed)) {
-                xpath_ret = xpath_search(match->xml, xpath);
-                if (numXpathResults(xpath_ret) < 1) {
-                    match = NULL;
-                }
-                freeXpathObject(xpath_ret);
-            } else {
-                // Only actions that were actually started can match
-                match = NULL;
-            }
+        // Only actions that were actually started can match
+        if (pcmk_is_set(action->flags, pcmk__graph_action_executed)) {
+            match = action;
+            break;
         }
     }
 
-    free(xpath);
-
     if (match != NULL) {
         crm_debug("Shutdown action %d (%s) found for node %s", match->id,
                   crm_element_value(match->xml, XML_LRM_ATTR_TASK_KEY), target);
@@ -151,6 +151,7 @@ static GMainLoop *mainloop = NULL;
 static lrmd_t *lrmd_conn = NULL;
 
 static char event_buf_v0[1024];
+static char event_buf_v1[2048]; // v0 plus exit reason, if any
 
 static void
 test_exit(crm_exit_t exit_code)
@@ -171,6 +172,12 @@ test_exit(crm_exit_t exit_code)
              event->op_type ? event->op_type : "none",                  \
              services_ocf_exitcode_str(event->rc),                      \
              pcmk_exec_status_str(event->op_status));                   \
+    if (event->exit_reason != NULL) {                                   \
+        snprintf(event_buf_v1, sizeof(event_buf_v1), "%s exit_reason:%s", \
+                 event_buf_v0, event->exit_reason);                     \
+    } else {                                                            \
+        event_buf_v1[0] = '\0';                                         \
+    }                                                                   \
     crm_info("%s", event_buf_v0);
 
 static void
@@ -185,7 +192,8 @@ read_events(lrmd_event_data_t * event)
 {
     report_event(event);
     if (options.listen) {
-        if (pcmk__str_eq(options.listen, event_buf_v0, pcmk__str_casei)) {
+        if (pcmk__str_eq(options.listen, event_buf_v0, pcmk__str_casei)
+            || pcmk__str_eq(options.listen, event_buf_v1, pcmk__str_casei)) {
             print_result(printf("LISTEN EVENT SUCCESSFUL\n"));
             test_exit(CRM_EX_OK);
         }
@@ -95,9 +95,12 @@ typedef struct lrmd_cmd_s {
     int last_pid;
 
     GHashTable *params;
+
+    bool coproc;    // Whether recurring op is run by agent coprocess
 } lrmd_cmd_t;
 
 static void cmd_finalize(lrmd_cmd_t * cmd, lrmd_rsc_t * rsc);
+static int lrmd_rsc_execute_service_lib(lrmd_rsc_t *rsc, lrmd_cmd_t *cmd);
 static gboolean lrmd_rsc_dispatch(gpointer user_data);
 static void cancel_all_recurring(lrmd_rsc_t * rsc, const char *client_id);
 
@@ -960,6 +963,97 @@ action_complete(svc_action_t * action)
     cmd_finalize(cmd, rsc);
 }
 
+/*!
+ * \internal
+ * \brief Stop a resource's agent coprocess if no recurring op still uses it
+ *
+ * \param[in,out] rsc  Resource to check
+ */
+static void
+stop_unused_coproc(lrmd_rsc_t *rsc)
+{
+    for (GList *iter = rsc->recurring_ops; iter != NULL; iter = iter->next) {
+        lrmd_cmd_t *cmd = iter->data;
+
+        if (cmd->coproc
+            && (cmd->result.execution_status != PCMK_EXEC_CANCELLED)) {
+            return;
+        }
+    }
+    for (GList *iter = rsc->pending_ops; iter != NULL; iter = iter->next) {
+        lrmd_cmd_t *cmd = iter->data;
+
+        if (cmd->coproc
+            && (cmd->result.execution_status != PCMK_EXEC_CANCELLED)) {
+            return;
+        }
+    }
+    execd_coproc_stop(rsc);
+}
+
+/*!
+ * \internal
+ * \brief Process the result of a recurring monitor run by an agent coprocess
+ *
+ * \param[in] pid          Process ID of coprocess (or 0 if unknown)
+ * \param[in] exit_status  Agent exit status
+ * \param[in] exec_status  Execution status
+ * \param[in] exit_reason  Human-friendly detail, if monitor failed
+ * \param[in] output       Agent output (this function takes ownership)
+ * \param[in] user_data    Monitor command
+ */
+static void
+coproc_action_complete(int pid, int exit_status,
+                       enum pcmk_exec_status exec_status,
+                       const char *exit_reason, char *output, void *user_data)
+{
+    lrmd_cmd_t *cmd = user_data;
+
+    // This can be NULL if resource was removed before command completed
+    lrmd_rsc_t *rsc = g_hash_table_lookup(rsc_list, cmd->rsc_id);
+
+    if (cmd->result.execution_status == PCMK_EXEC_CANCELLED) {
+        // The execution status is already correct, so don't overwrite it
+        exec_status = PCMK_EXEC_CANCELLED;
+
+    } else if ((exec_status == PCMK_EXEC_NOT_CONNECTED) && (rsc != NULL)) {
+        /* The coprocess went away without replying, so execute the monitor
+         * the usual way (the service library will handle recurrence from now on)
+         */
+        crm_info("Executing %s %s without agent coprocess",
+                 cmd->rsc_id, cmd->action);
+        free(output);
+        cmd->coproc = false;
+        lrmd_rsc_execute_service_lib(rsc, cmd);
+        return;
+    }
+
+#ifdef PCMK__TIME_USE_CGT
+    if (cmd->result.exit_status != exit_status) {
+        cmd->epoch_rcchange = time(NULL);
+    }
+#endif
+
+    cmd->last_pid = pid;
+    pcmk__set_result(&(cmd->result),
+                     (int) services_result2ocf(PCMK_RESOURCE_CLASS_OCF,
+                                               cmd->action, exit_status),
+                     exec_status, exit_reason);
+    pcmk__set_result_output(&(cmd->result), output, NULL);
+
+    // As for fence device monitors, we must reschedule the command ourselves
+    stop_recurring_timer(cmd);
+    if (rsc && (cmd->result.execution_status != PCMK_EXEC_CANCELLED)) {
+        start_recurring_timer(cmd);
+    }
+    cmd_finalize(cmd, rsc);
+
+    // If the monitor was cancelled while in flight, the agent may be idle now
+    if ((rsc != NULL) && (exec_status == PCMK_EXEC_CANCELLED)) {
+        stop_unused_coproc(rsc);
+    }
+}
+
 /*!
  * \internal
  * \brief Process the result of a fence device action (start, stop, or monitor)
@@ -1277,6 +1371,31 @@ lrmd_rsc_execute_stonith(lrmd_rsc_t * rsc, lrmd_cmd_t * cmd)
                             ((rc == -pcmk_err_generic)? NULL : pcmk_strerror(rc)));
 }
 
+/*!
+ * \internal
+ * \brief Execute a recurring monitor via the resource's agent coprocess
+ *
+ * \param[in,out] rsc  Resource to execute command for
+ * \param[in,out] cmd  Command to execute
+ *
+ * \return true if the coprocess is executing \p cmd, otherwise false
+ */
+static bool
+lrmd_rsc_execute_coproc(lrmd_rsc_t *rsc, lrmd_cmd_t *cmd)
+{
+    if (!pcmk__str_eq(cmd->action, "monitor", pcmk__str_casei)) {
+        // Let the agent start over once any other action has changed things
+        execd_coproc_stop(rsc);
+        return false;
+    }
+
+    cmd->coproc = (cmd->interval_ms > 0)
+                  && (execd_coproc_monitor(rsc, cmd->params, cmd->timeout,
+                                           coproc_action_complete,
+                                           cmd) == pcmk_rc_ok);
+    return cmd->coproc;
+}
+
 static int
 lrmd_rsc_execute_service_lib(lrmd_rsc_t * rsc, lrmd_cmd_t * cmd)
 {
@@ -1385,7 +1504,7 @@ lrmd_rsc_execute(lrmd_rsc_t * rsc)
 
     if (pcmk__str_eq(rsc->class, PCMK_RESOURCE_CLASS_STONITH, pcmk__str_casei)) {
         lrmd_rsc_execute_stonith(rsc, cmd);
-    } else {
+    } else if (!lrmd_rsc_execute_coproc(rsc, cmd)) {
         lrmd_rsc_execute_service_lib(rsc, cmd);
     }
 
@@ -1406,6 +1525,9 @@ free_rsc(gpointer data)
     int is_stonith = pcmk__str_eq(rsc->class, PCMK_RESOURCE_CLASS_STONITH,
                                   pcmk__str_casei);
 
+    // Any command in flight in the coprocess will not get a result
+    execd_coproc_free(rsc);
+
     gIter = rsc->pending_ops;
     while (gIter != NULL) {
         GList *next = gIter->next;
@@ -1425,7 +1547,11 @@ free_rsc(gpointer data)
         GList *next = gIter->next;
         lrmd_cmd_t *cmd = gIter->data;
 
-        if (is_stonith) {
+        if (cmd->coproc) {
+            cmd->result.execution_status = PCMK_EXEC_CANCELLED;
+            cmd_finalize(cmd, NULL);
+
+        } else if (is_stonith) {
             cmd->result.execution_status = PCMK_EXEC_CANCELLED;
             /* If a stonith command is in-flight, just mark it as cancelled;
              * it is not safe to finalize/free the cmd until the stonith api
@@ -1510,6 +1636,7 @@ process_lrmd_rsc_register(pcmk__client_t *client, uint32_t id, xmlNode *request)
 
     g_hash_table_replace(rsc_list, rsc->rsc_id, rsc);
     crm_info("Cached agent information for '%s'", rsc->rsc_id);
+    execd_coproc_check_agent(rsc);
     return rc;
 }
 
@@ -1606,6 +1733,7 @@ static int
 cancel_op(const char *rsc_id, const char *action, guint interval_ms)
 {
     GList *gIter = NULL;
+    bool is_stonith = false;
     lrmd_rsc_t *rsc = g_hash_table_lookup(rsc_list, rsc_id);
 
     /* How to cancel an action.
@@ -1629,27 +1757,38 @@ cancel_op(const char *rsc_id, const char *action, guint interval_ms)
         if (action_matches(cmd, action, interval_ms)) {
             cmd->result.execution_status = PCMK_EXEC_CANCELLED;
             cmd_finalize(cmd, rsc);
+            stop_unused_coproc(rsc);
             return pcmk_ok;
         }
     }
 
-    if (pcmk__str_eq(rsc->class, PCMK_RESOURCE_CLASS_STONITH, pcmk__str_casei)) {
-        /* The service library does not handle stonith operations.
-         * We have to handle recurring stonith operations ourselves. */
-        for (gIter = rsc->recurring_ops; gIter != NULL; gIter = gIter->next) {
-            lrmd_cmd_t *cmd = gIter->data;
-
-            if (action_matches(cmd, action, interval_ms)) {
-                cmd->result.execution_status = PCMK_EXEC_CANCELLED;
-                if (rsc->active != cmd) {
-                    cmd_finalize(cmd, rsc);
-                }
-                return pcmk_ok;
+    /* The service library does not handle stonith operations or operations
+     * run by an agent coprocess. We have to handle those recurring operations
+     * ourselves.
+     */
+    is_stonith = pcmk__str_eq(rsc->class, PCMK_RESOURCE_CLASS_STONITH,
+                              pcmk__str_casei);
+    for (gIter = rsc->recurring_ops; gIter != NULL; gIter = gIter->next) {
+        lrmd_cmd_t *cmd = gIter->data;
+
+        if ((is_stonith || cmd->coproc)
+            && action_matches(cmd, action, interval_ms)) {
+            cmd->result.execution_status = PCMK_EXEC_CANCELLED;
+            if (rsc->active != cmd) {
+                cmd_finalize(cmd, rsc);
             }
+
+            /* If the monitor is in flight, this does nothing, and
+             * coproc_action_complete() will try again once it finishes
+             */
+            stop_unused_coproc(rsc);
+            return pcmk_ok;
         }
-    } else if (services_action_cancel(rsc_id,
-                                      normalize_action_name(rsc, action),
-                                      interval_ms) == TRUE) {
+    }
+
+    if (!is_stonith
+        && services_action_cancel(rsc_id, normalize_action_name(rsc, action),
+                                  interval_ms) == TRUE) {
         /* The service library will tell the action_complete callback function
          * this action was cancelled, which will destroy the cmd and remove
          * it from the recurring_op list. Do not do that in this function
@@ -0,0 +1,692 @@
+/*
+ * Copyright 2022 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU Lesser General Public License
+ * version 2.1 or later (LGPLv2.1+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <glib.h>
+
+#include <crm/crm.h>
+#include <crm/services.h>
+#include <crm/services_internal.h>
+#include <crm/common/mainloop.h>
+#include <crm/common/iso8601_internal.h>
+#include <crm/msg_xml.h>
+
+#include "pacemaker-execd.h"
+
+/* Agent coprocesses
+ *
+ * Recurring monitors are normally run by executing the agent anew each time.
+ * An OCF agent may instead advertise a "coprocess" action in its meta-data, in
+ * which case the executor runs "<agent> coprocess" once per resource (with the
+ * resource's usual OCF environment) and sends it recurring monitor requests
+ * over its standard input:
+ *
+ * - Each request is a single line, "monitor".
+ * - The agent replies with any output for the monitor, followed by a line
+ *   "pcmk-coprocess-rc:<exit status>". An output line beginning with
+ *   "ocf-exit-reason:" sets the exit reason, as it would on error output.
+ * - Only one request is outstanding at a time. The agent is killed if it does
+ *   not reply within the monitor's timeout, and may be killed at any time it
+ *   has no request outstanding (for example, before any other action for the
+ *   resource is executed).
+ *
+ * If the coprocess cannot be started or goes away without replying, the
+ * monitor is executed the usual way instead, and a resource whose coprocess
+ * keeps going away stops using one.
+ */
+
+#define COPROC_ACTION           "coprocess"
+#define COPROC_REQUEST          "monitor\n"
+#define COPROC_RESULT_PREFIX    "pcmk-coprocess-rc:"
+
+// How many times in a row a coprocess may go away before we stop using it
+#define COPROC_MAX_FAILURES     3
+
+// Maximum size of a coprocess's reply (anything bigger is a protocol error)
+#define COPROC_MAX_REPLY        (1024 * 1024)
+
+// How long to wait for an agent's meta-data (in milliseconds)
+#define COPROC_METADATA_TIMEOUT 30000
+
+enum coproc_support {
+    coproc_unknown = 0,
+    coproc_checking,
+    coproc_supported,
+    coproc_unsupported,
+};
+
+struct execd_coproc_s {
+    svc_action_t *action;       // Action used to launch agent (if running)
+    int fd;                     // Connection to agent (or -1)
+    mainloop_io_t *source;      // Mainloop source for connection
+    GString *reply;             // Reply received so far
+    int failures;               // How many times in a row agent went away
+
+    // Outstanding request, if any
+    execd_coproc_cb_t callback;
+    void *user_data;
+    int timeout_ms;
+    guint timer;
+};
+
+// enum coproc_support values, keyed by "<provider>:<agent>"
+static GHashTable *agent_support = NULL;
+
+// execd_coproc_t objects, keyed by agent PID
+static GHashTable *coproc_pids = NULL;
+
+static inline bool
+is_ocf_rsc(const lrmd_rsc_t *rsc)
+{
+    return pcmk__str_eq(rsc->class, PCMK_RESOURCE_CLASS_OCF, pcmk__str_casei)
+           && (rsc->provider != NULL) && (rsc->type != NULL);
+}
+
+static inline char *
+agent_key(const lrmd_rsc_t *rsc)
+{
+    return crm_strdup_printf("%s:%s", rsc->provider, rsc->type);
+}
+
+static void
+metadata_complete(svc_action_t *action)
+{
+    char *key = action->cb_data;
+    enum coproc_support support = coproc_unsupported;
+    xmlNode *metadata = NULL;
+
+    action->cb_data = NULL;
+    if (agent_support == NULL) {
+        free(key); // We're shutting down
+        return;
+    }
+
+    if ((action->rc == PCMK_OCF_OK) && (action->status == PCMK_EXEC_DONE)
+        && (action->stdout_data != NULL)) {
+        metadata = string2xml(action->stdout_data);
+    }
+
+    if (metadata != NULL) {
+        xmlNode *match = first_named_child(metadata, "actions");
+
+        for (match = first_named_child(match, "action"); match != NULL;
+             match = crm_next_same_xml(match)) {
+
+            if (pcmk__str_eq(crm_element_value(match, "name"), COPROC_ACTION,
+                             pcmk__str_none)) {
+                support = coproc_supported;
+                break;
+            }
+        }
+        free_xml(metadata);
+    }
+
+    if (support == coproc_supported) {
+        crm_info("Recurring monitors for ocf:%s resources will use an agent "
+                 "coprocess", key);
+    }
+    g_hash_table_replace(agent_support, key, GINT_TO_POINTER(support));
+}
+
+/*!
+ * \internal
+ * \brief Find out (asynchronously) whether a resource's agent has a coprocess
+ *
+ * \param[in] rsc  Resource to check
+ */
+void
+execd_coproc_check_agent(const lrmd_rsc_t *rsc)
+{
+    char *key = NULL;
+    svc_action_t *action = NULL;
+
+    if (!is_ocf_rsc(rsc)) {
+        return;
+    }
+    if (agent_support == NULL) {
+        agent_support = pcmk__strkey_table(free, NULL);
+    }
+
+    key = agent_key(rsc);
+    if (g_hash_table_lookup(agent_support, key) != NULL) {
+        free(key); // Already known or being checked
+        return;
+    }
+
+    /* Use the agent as the action name, so the check doesn't block (or get
+     * blocked by) the resource's own actions
+     */
+    action = services__create_resource_action(key, PCMK_RESOURCE_CLASS_OCF,
+                                              rsc->provider, rsc->type,
+                                              "meta-data", 0,
+                                              COPROC_METADATA_TIMEOUT, NULL,
+                                              SVC_ACTION_NON_BLOCKED);
+    if ((action == NULL) || (action->rc != PCMK_OCF_UNKNOWN)) {
+        services_action_free(action);
+        g_hash_table_insert(agent_support, key,
+                            GINT_TO_POINTER(coproc_unsupported));
+        return;
+    }
+
+    g_hash_table_insert(agent_support, strdup(key),
+                        GINT_TO_POINTER(coproc_checking));
+    action->cb_data = key;
+    if (!services_action_async(action, metadata_complete)) {
+        key = action->cb_data;
+        action->cb_data = NULL;
+        services_action_free(action);
+        if (key != NULL) {
+            g_hash_table_replace(agent_support, key,
+                                 GINT_TO_POINTER(coproc_unsupported));
+        }
+    }
+}
+
+static bool
+agent_supports_coproc(const lrmd_rsc_t *rsc)
+{
+    char *key = NULL;
+    enum coproc_support support = coproc_unknown;
+
+    if (!is_ocf_rsc(rsc) || (agent_support == NULL)) {
+        return false;
+    }
+    key = agent_key(rsc);
+    support = GPOINTER_TO_INT(g_hash_table_lookup(agent_support, key));
+    free(key);
+    return support == coproc_supported;
+}
+
+/*!
+ * \internal
+ * \brief Check whether every resource parameter in one table is in another
+ *
+ * \param[in] params1  Parameters to check
+ * \param[in] params2  Parameters to check against
+ *
+ * \return true if every parameter in \p params1 (other than meta-attributes)
+ *         has the same value in \p params2, otherwise false
+ */
+static bool
+params_in(GHashTable *params1, GHashTable *params2)
+{
+    GHashTableIter iter;
+    const char *name = NULL;
+    const char *value = NULL;
+
+    if (params1 == NULL) {
+        return true;
+    }
+    g_hash_table_iter_init(&iter, params1);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &name,
+                                  (gpointer *) &value)) {
+        if (pcmk__starts_with(name, CRM_META "_")) {
+            continue;
+        }
+        if ((params2 == NULL)
+            || !pcmk__str_eq(value, g_hash_table_lookup(params2, name),
+                             pcmk__str_none)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void
+coproc_source_destroyed(gpointer user_data)
+{
+    execd_coproc_t *coproc = user_data;
+
+    coproc->source = NULL;
+}
+
+static void
+stop_coproc(execd_coproc_t *coproc)
+{
+    pid_t pid = 0;
+
+    if (coproc->action == NULL) {
+        return;
+    }
+    pid = coproc->action->pid;
+    crm_debug("Stopping %s coprocess [%d]", coproc->action->rsc, pid);
+
+    if (coproc->timer != 0) {
+        g_source_remove(coproc->timer);
+        coproc->timer = 0;
+    }
+    if (coproc->source != NULL) {
+        mainloop_del_fd(coproc->source);
+        coproc->source = NULL;
+    }
+    if (coproc->fd >= 0) {
+        close(coproc->fd);
+        coproc->fd = -1;
+    }
+    g_string_truncate(coproc->reply, 0);
+
+    if (pid > 0) {
+        /* Forget the agent first, so its exit isn't treated as unexpected. Don't
+         * wait for it to die, because an agent stuck in the kernel (for
+         * example, on hung storage) would block us. The mainloop child handler
+         * will reap it whenever it does die.
+         */
+        pcmk__intkey_table_remove(coproc_pids, pid);
+        if ((kill(-pid, SIGKILL) < 0) && (errno != ESRCH)) {
+            crm_perror(LOG_WARNING, "Could not kill %s coprocess [%d]",
+                       coproc->action->rsc, pid);
+        }
+    }
+    services_action_free(coproc->action);
+    coproc->action = NULL;
+}
+
+/*!
+ * \internal
+ * \brief Report the result of a coprocess's outstanding request
+ *
+ * \param[in,out] coproc       Coprocess whose request is finished
+ * \param[in]     pid          Process ID of coprocess that ran request
+ * \param[in]     exit_status  Agent exit status for request
+ * \param[in]     exec_status  Execution status for request
+ * \param[in]     exit_reason  Human-friendly detail, if request failed
+ * \param[in]     output       Agent output for request (callback takes it)
+ */
+static void
+finish_request(execd_coproc_t *coproc, int pid, int exit_status,
+               enum pcmk_exec_status exec_status, const char *exit_reason,
+               char *output)
+{
+    execd_coproc_cb_t callback = coproc->callback;
+    void *user_data = coproc->user_data;
+
+    coproc->callback = NULL;
+    coproc->user_data = NULL;
+    if (coproc->timer != 0) {
+        g_source_remove(coproc->timer);
+        coproc->timer = 0;
+    }
+
+    if (callback != NULL) {
+        callback(pid, exit_status, exec_status, exit_reason, output, user_data);
+    } else {
+        free(output);
+    }
+}
+
+static void
+coproc_lost(execd_coproc_t *coproc, const char *reason)
+{
+    const char *rsc_id = coproc->action->rsc;
+
+    crm_notice("%s coprocess [%d] %s", rsc_id, coproc->action->pid, reason);
+    if (++(coproc->failures) == COPROC_MAX_FAILURES) {
+        crm_warn("Recurring monitors for %s will no longer use an agent "
+                 "coprocess because it went away %d times in a row",
+                 rsc_id, coproc->failures);
+    }
+    stop_coproc(coproc);
+
+    // Let the caller execute the request the usual way instead
+    finish_request(coproc, 0, PCMK_OCF_UNKNOWN_ERROR, PCMK_EXEC_NOT_CONNECTED,
+                   NULL, NULL);
+}
+
+static void
+coproc_exited(mainloop_child_t *p, pid_t pid, int core, int signo,
+              int exitcode)
+{
+    execd_coproc_t *coproc = pcmk__intkey_table_lookup(coproc_pids, pid);
+
+    if (coproc == NULL) {
+        return; // We stopped it
+    }
+    pcmk__intkey_table_remove(coproc_pids, pid);
+    coproc->action->pid = 0; // Already reaped, so don't try to kill it
+
+    if (signo == 0) {
+        char *reason = crm_strdup_printf("exited with status %d", exitcode);
+
+        coproc_lost(coproc, reason);
+        free(reason);
+    } else {
+        coproc_lost(coproc, strsignal(signo));
+    }
+}
+
+static gboolean
+coproc_timed_out(gpointer user_data)
+{
+    execd_coproc_t *coproc = user_data;
+    int pid = coproc->action->pid;
+    char *reason = crm_strdup_printf("Coprocess did not reply within %s",
+                                     pcmk__readable_interval(coproc->timeout_ms));
+
+    coproc->timer = 0;
+    crm_info("%s coprocess [%d] did not reply within %s",
+             coproc->action->rsc, pid,
+             pcmk__readable_interval(coproc->timeout_ms));
+    stop_coproc(coproc);
+    finish_request(coproc, pid, PCMK_OCF_UNKNOWN_ERROR, PCMK_EXEC_TIMEOUT,
+                   reason, NULL);
+    free(reason);
+    return G_SOURCE_REMOVE;
+}
+
+/*!
+ * \internal
+ * \brief Process a coprocess's reply, if it is complete
+ *
+ * \param[in,out] coproc  Coprocess to check
+ *
+ * \return Standard Pacemaker return code (pcmk_rc_ok if reply is valid or
+ *         incomplete)
+ */
+static int
+process_reply(execd_coproc_t *coproc)
+{
+    char *output = coproc->reply->str;
+    char *result = output;
+    char *end = NULL;
+    char *reason = NULL;
+    int exit_status = PCMK_OCF_UNKNOWN_ERROR;
+
+    // Find the result line, which ends the reply
+    while ((result != NULL)
+           && !pcmk__starts_with(result, COPROC_RESULT_PREFIX)) {
+        result = strchr(result, '\n');
+        if (result != NULL) {
+            result++;
+        }
+    }
+    if ((result == NULL) || ((end = strchr(result, '\n')) == NULL)) {
+        return pcmk_rc_ok;
+    }
+
+    *end = '\0';
+    if (pcmk__scan_min_int(result + strlen(COPROC_RESULT_PREFIX),
+                           &exit_status, INT_MIN) != pcmk_rc_ok) {
+        return pcmk_rc_bad_nvpair;
+    }
+    if (*(end + 1) != '\0') {
+        crm_warn("Ignoring %s coprocess output after result",
+                 coproc->action->rsc);
+    }
+
+    // The last exit reason in the output wins, as with error output
+    *result = '\0';
+    for (char *line = output; *line != '\0'; line = end + 1) {
+        end = strchr(line, '\n');
+        if (pcmk__starts_with(line, PCMK_OCF_REASON_PREFIX)) {
+            free(reason);
+            reason = (end == NULL)? strdup(line) : strndup(line, end - line);
+        }
+        if (end == NULL) {
+            break;
+        }
+    }
+
+    coproc->failures = 0;
+    finish_request(coproc, coproc->action->pid, exit_status, PCMK_EXEC_DONE,
+                   ((reason == NULL)? NULL
+                    : reason + strlen(PCMK_OCF_REASON_PREFIX)),
+                   ((*output == '\0')? NULL : strdup(output)));
+    free(reason);
+
+    /* The callback may have stopped the coprocess (if the monitor was
+     * cancelled while in flight and no other monitor uses the coprocess), in
+     * which case this is a no-op
+     */
+    g_string_truncate(coproc->reply, 0);
+    return pcmk_rc_ok;
+}
+
+static int
+coproc_dispatch(gpointer user_data)
+{
+    execd_coproc_t *coproc = user_data;
+    char buffer[1024];
+    ssize_t rc = 0;
+    int read_errno = 0;
+
+    do {
+        rc = read(coproc->fd, buffer, sizeof(buffer));
+        if (rc > 0) {
+            g_string_append_len(coproc->reply, buffer, rc);
+        }
+    } while ((rc > 0) && (coproc->reply->len <= COPROC_MAX_REPLY));
+    read_errno = (rc < 0)? errno : 0;
+
+    if (coproc->callback == NULL) {
+        if (coproc->reply->len > 0) {
+            crm_warn("Ignoring unexpected output from %s coprocess",
+                     coproc->action->rsc);
+            g_string_truncate(coproc->reply, 0);
+        }
+
+    } else if ((coproc->reply->len > COPROC_MAX_REPLY)
+               || (process_reply(coproc) != pcmk_rc_ok)) {
+        coproc->source = NULL; // Mainloop will remove it when we return
+        coproc_lost(coproc, "sent an invalid reply");
+        return -1;
+    }
+
+    if (coproc->action == NULL) {
+        /* The result callback stopped the coprocess (which also removed this
+         * source), so it doesn't matter whether the agent has exited too
+         */
+        return -1;
+    }
+
+    if ((rc == 0) || ((rc < 0) && (read_errno != EAGAIN)
+                      && (read_errno != EINTR))) {
+        coproc->source = NULL;
+        coproc_lost(coproc, "closed its connection");
+        return -1;
+    }
+    return 0;
+}
+
+static struct mainloop_fd_callbacks coproc_callbacks = {
+    .dispatch = coproc_dispatch,
+    .destroy = coproc_source_destroyed,
+};
+
+static int
+start_coproc(lrmd_rsc_t *rsc, GHashTable *params, int timeout)
+{
+    execd_coproc_t *coproc = rsc->coproc;
+    int rc = pcmk_rc_ok;
+
+    coproc->action = services__create_resource_action(rsc->rsc_id, rsc->class,
+                                                      rsc->provider, rsc->type,
+                                                      COPROC_ACTION, 0, timeout,
+                                                      pcmk__str_table_dup(params),
+                                                      0);
+    if (coproc->action == NULL) {
+        return ENOMEM;
+    }
+    if (coproc->action->rc != PCMK_OCF_UNKNOWN) {
+        rc = ENOEXEC;
+        goto done;
+    }
+
+    rc = services__launch_coprocess(coproc->action, &(coproc->fd));
+    if (rc != pcmk_rc_ok) {
+        goto done;
+    }
+
+    if (coproc_pids == NULL) {
+        coproc_pids = pcmk__intkey_table(NULL);
+    }
+    pcmk__intkey_table_insert(coproc_pids, coproc->action->pid, coproc);
+    mainloop_child_add(coproc->action->pid, 0, coproc->action->id, NULL,
+                       coproc_exited);
+
+    coproc->source = mainloop_add_fd(coproc->action->id, G_PRIORITY_LOW,
+                                     coproc->fd, coproc, &coproc_callbacks);
+    if (coproc->source == NULL) {
+        rc = ENOMEM;
+        goto done;
+    }
+    crm_info("Started %s coprocess [%d]", rsc->rsc_id, coproc->action->pid);
+
+done:
+    if (rc != pcmk_rc_ok) {
+        crm_info("Could not start %s coprocess: %s",
+                 rsc->rsc_id, pcmk_rc_str(rc));
+        stop_coproc(coproc);
+    }
+    return rc;
+}
+
+/*!
+ * \internal
+ * \brief Send a recurring monitor to a resource's agent coprocess
+ *
+ * \param[in,out] rsc         Resource to monitor
+ * \param[in]     params      Monitor parameters
+ * \param[in]     timeout_ms  Monitor timeout
+ * \param[in]     callback    Function to call with result
+ * \param[in]     user_data   Data to pass to \p callback
+ *
+ * \return Standard Pacemaker return code (if not pcmk_rc_ok, the monitor
+ *         should be executed the usual way, and \p callback will not be called)
+ * \note If the coprocess goes away without replying, \p callback will be
+ *       called with PCMK_EXEC_NOT_CONNECTED, and the monitor should be
+ *       executed the usual way.
+ */
+int
+execd_coproc_monitor(lrmd_rsc_t *rsc, GHashTable *params, int timeout_ms,
+                     execd_coproc_cb_t callback, void *user_data)
+{
+    execd_coproc_t *coproc = NULL;
+    int rc = pcmk_rc_ok;
+
+    CRM_CHECK((rsc != NULL) && (callback != NULL), return EINVAL);
+
+    if (!agent_supports_coproc(rsc)) {
+        return ENOTSUP;
+    }
+    if (rsc->coproc == NULL) {
+        rsc->coproc = calloc(1, sizeof(execd_coproc_t));
+        if (rsc->coproc == NULL) {
+            return ENOMEM;
+        }
+        rsc->coproc->fd = -1;
+        rsc->coproc->reply = g_string_sized_new(256);
+    }
+    coproc = rsc->coproc;
+
+    if ((coproc->failures >= COPROC_MAX_FAILURES)
+        || (coproc->callback != NULL)) {
+        return ENOTSUP;
+    }
+
+    if (coproc->action != NULL) {
+        /* Monitors with different parameters (such as OCF_CHECK_LEVEL) can't
+         * share a coprocess, so leave all but the first to be run as usual
+         */
+        if (!params_in(params, coproc->action->params)
+            || !params_in(coproc->action->params, params)) {
+            return ENOTSUP;
+        }
+
+    } else {
+        rc = start_coproc(rsc, params, timeout_ms);
+        if (rc != pcmk_rc_ok) {
+            coproc->failures++;
+            return rc;
+        }
+    }
+
+    if (send(coproc->fd, COPROC_REQUEST, strlen(COPROC_REQUEST),
+             MSG_NOSIGNAL) < 0) {
+        rc = errno;
+        crm_info("Could not send monitor request to %s coprocess: %s",
+                 rsc->rsc_id, pcmk_rc_str(rc));
+        coproc->failures++;
+        stop_coproc(coproc);
+        return rc;
+    }
+
+    coproc->callback = callback;
+    coproc->user_data = user_data;
+    coproc->timeout_ms = timeout_ms;
+    if (timeout_ms > 0) {
+        coproc->timer = g_timeout_add(timeout_ms, coproc_timed_out, coproc);
+    }
+    crm_trace("Sent monitor request to %s coprocess [%d]",
+              rsc->rsc_id, coproc->action->pid);
+    return pcmk_rc_ok;
+}
+
+/*!
+ * \internal
+ * \brief Stop a resource's agent coprocess, if running
+ *
+ * \param[in,out] rsc  Resource whose coprocess should be stopped
+ *
+ * \note The coprocess will be started again by the next recurring monitor.
+ *       Nothing is done if a monitor request is outstanding.
+ */
+void
+execd_coproc_stop(lrmd_rsc_t *rsc)
+{
+    if ((rsc->coproc != NULL) && (rsc->coproc->callback == NULL)) {
+        stop_coproc(rsc->coproc);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Stop and free a resource's agent coprocess, if any
+ *
+ * \param[in,out] rsc  Resource whose coprocess should be freed
+ *
+ * \note Any outstanding request's callback will not be called.
+ */
+void
+execd_coproc_free(lrmd_rsc_t *rsc)
+{
+    if (rsc->coproc != NULL) {
+        rsc->coproc->callback = NULL;
+        stop_coproc(rsc->coproc);
+        g_string_free(rsc->coproc->reply, TRUE);
+        free(rsc->coproc);
+        rsc->coproc = NULL;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Free global agent coprocess data
+ *
+ * \note All coprocesses should already have been freed via free_rsc().
+ */
+void
+execd_coproc_cleanup(void)
+{
+    if (agent_support != NULL) {
+        g_hash_table_destroy(agent_support);
+        agent_support = NULL;
+    }
+    if (coproc_pids != NULL) {
+        g_hash_table_destroy(coproc_pids);
+        coproc_pids = NULL;
+    }
+}
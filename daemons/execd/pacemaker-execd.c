@@ -113,13 +113,14 @@ lrmd_ipc_dispatch(qb_ipcs_connection_t * c, void *data, size_t size)
     CRM_CHECK(client->id != NULL, crm_err("Invalid client: %p", client);
               return FALSE);
 
-    CRM_CHECK(flags & crm_ipc_client_response, crm_err("Invalid client request: %p", client);
-              return FALSE);
-
     if (!request) {
+        // Invalid, or only part of a multipart request so far
         return 0;
     }
 
+    CRM_CHECK(flags & crm_ipc_client_response, crm_err("Invalid client request: %p", client);
+              free_xml(request); return FALSE);
+
     if (!client->name) {
         const char *value = crm_element_value(request, F_LRMD_CLIENTNAME);
 
@@ -277,6 +278,7 @@ lrmd_exit(gpointer data)
 
     pcmk__client_cleanup();
     g_hash_table_destroy(rsc_list);
+    execd_coproc_cleanup();
 
     if (mainloop) {
         lrmd_drain_alerts(mainloop);
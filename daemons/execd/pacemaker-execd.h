@@ -21,6 +21,8 @@
 
 extern GHashTable *rsc_list;
 
+typedef struct execd_coproc_s execd_coproc_t;
+
 typedef struct lrmd_rsc_s {
     char *rsc_id;
     char *class;
@@ -51,6 +53,9 @@ typedef struct lrmd_rsc_s {
     pcmk__action_result_t fence_probe_result;
 
     crm_trigger_t *work;
+
+    // Agent coprocess for recurring monitors, if any (see execd_coprocess.c)
+    execd_coproc_t *coproc;
 } lrmd_rsc_t;
 
 #  ifdef HAVE_GNUTLS_GNUTLS_H
@@ -102,6 +107,31 @@ int ipc_proxy_shutdown_req(pcmk__client_t *ipc_proxy);
 void remoted_spawn_pidone(int argc, char **argv, char **envp);
 #endif
 
+// in execd_coprocess.c
+
+/*!
+ * \internal
+ * \brief Callback for the result of an agent coprocess monitor request
+ *
+ * \param[in] pid          Process ID of coprocess (or 0 if unknown)
+ * \param[in] exit_status  Agent exit status
+ * \param[in] exec_status  Execution status
+ * \param[in] exit_reason  Human-friendly detail, if request failed
+ * \param[in] output       Agent output (callback takes ownership)
+ * \param[in] user_data    Data passed when request was sent
+ */
+typedef void (*execd_coproc_cb_t)(int pid, int exit_status,
+                                  enum pcmk_exec_status exec_status,
+                                  const char *exit_reason, char *output,
+                                  void *user_data);
+
+void execd_coproc_check_agent(const lrmd_rsc_t *rsc);
+int execd_coproc_monitor(lrmd_rsc_t *rsc, GHashTable *params, int timeout_ms,
+                         execd_coproc_cb_t callback, void *user_data);
+void execd_coproc_stop(lrmd_rsc_t *rsc);
+void execd_coproc_free(lrmd_rsc_t *rsc);
+void execd_coproc_cleanup(void);
+
 int process_lrmd_alert_exec(pcmk__client_t *client, uint32_t id,
                             xmlNode *request);
 void lrmd_drain_alerts(GMainLoop *mloop);
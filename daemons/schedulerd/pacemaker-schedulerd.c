@@ -163,6 +163,8 @@ pengine_shutdown(int nsig)
         ipcs = NULL;
     }
 
+    schedulerd_free_result_cache();
+
     if (logger_out != NULL) {
         logger_out->finish(logger_out, exit_code, true, NULL);
         pcmk__output_free(logger_out);
@@ -17,4 +17,6 @@ extern pcmk__output_t *logger_out;
 extern pcmk__output_t *out;
 extern struct qb_ipcs_service_handlers ipc_callbacks;
 
+void schedulerd_free_result_cache(void);
+
 #endif
@@ -12,7 +12,9 @@
 #include <crm/msg_xml.h>
 #include <pacemaker-internal.h>
 
+#include <errno.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -36,6 +38,218 @@ init_working_set(void)
     return data_set;
 }
 
+// Most recent scheduler result, reused if the same input is received again
+static struct {
+    char *digest;       // Versioned digest of input that result is for
+    xmlNode *graph;     // Transition graph (NULL if result can't be reused)
+    time_t recheck_by;  // When graph becomes outdated (or 0 for never)
+    int series_id;      // Index into series[] that input belongs to
+    int series_wrap;    // Maximum number of inputs of that kind to save
+    gboolean processing_error;
+    gboolean processing_warning;
+    gboolean config_error;
+    gboolean config_warning;
+} last_result = { NULL, };
+
+/*!
+ * \internal
+ * \brief Forget the most recent scheduler result
+ *
+ * \param[in] keep_digest  If true, keep remembering the result's input digest
+ */
+static void
+clear_last_result(bool keep_digest)
+{
+    if (!keep_digest) {
+        free(last_result.digest);
+        last_result.digest = NULL;
+    }
+    free_xml(last_result.graph);
+    last_result.graph = NULL;
+    last_result.recheck_by = 0;
+}
+
+/*!
+ * \internal
+ * \brief Free the scheduler result cache
+ */
+void
+schedulerd_free_result_cache(void)
+{
+    clear_last_result(false);
+}
+
+/*!
+ * \internal
+ * \brief Check whether the scheduler result for an input may be reused
+ *
+ * The scheduler's result depends on the current time only through the
+ * working set's recheck time, except when date expressions are used in rules
+ * (not all rule evaluations track when their result will next change), so the
+ * result for input with date expressions is never reused.
+ *
+ * \param[in] input  Scheduler input XML (CIB)
+ *
+ * \return true if result for \p input may be reused, otherwise false
+ */
+static bool
+result_is_reusable(xmlNode *input)
+{
+    xmlXPathObjectPtr xpathObj = xpath_search(input,
+                                              "//" XML_CIB_TAG_CONFIGURATION
+                                              "//date_expression");
+    bool reusable = (numXpathResults(xpathObj) == 0);
+
+    freeXpathObject(xpathObj);
+    return reusable;
+}
+
+/* Maximum number of scheduler inputs that may be saved to disk concurrently by
+ * child processes. Beyond this, inputs are saved synchronously, which throttles
+ * the scheduler rather than letting an unbounded number of writers pile up.
+ */
+#define MAX_INPUT_WRITERS 4
+
+// Number of child processes currently saving scheduler inputs to disk
+static int active_input_writers = 0;
+
+static void
+input_write_complete(mainloop_child_t *p, pid_t pid, int core, int signo,
+                     int exitcode)
+{
+    char *filename = mainloop_child_userdata(p);
+
+    active_input_writers--;
+
+    if (signo != 0) {
+        crm_err("Could not save scheduler input to %s: process %d "
+                "terminated with signal %d (%s)%s",
+                filename, (int) pid, signo, strsignal(signo),
+                (core? " and dumped core" : ""));
+
+    } else if (exitcode != CRM_EX_OK) {
+        crm_err("Could not save scheduler input to %s: process %d exited %d",
+                filename, (int) pid, exitcode);
+
+    } else {
+        crm_trace("Saved scheduler input to %s (process %d)",
+                  filename, (int) pid);
+    }
+    free(filename);
+}
+
+/*!
+ * \internal
+ * \brief Write a scheduler input to disk
+ *
+ * Anything reading the input series expects complete files, so write to a
+ * temporary file in the same directory and rename it into place.
+ *
+ * \param[in] input     Scheduler input XML to write
+ * \param[in] filename  Where to write \p input
+ *
+ * \return Standard Pacemaker return code
+ */
+static int
+write_input(xmlNode *input, const char *filename)
+{
+    char *tmp_file = crm_strdup_printf("%s.XXXXXX", filename);
+    mode_t mask = 0;
+    int rc = pcmk_rc_ok;
+    int fd = mkstemp(tmp_file);
+
+    if (fd < 0) {
+        rc = errno;
+        crm_err("Could not create temporary file to save scheduler input "
+                "to %s: %s", filename, pcmk_rc_str(rc));
+        free(tmp_file);
+        return rc;
+    }
+
+    // mkstemp() creates the file private, but the input should be as readable
+    mask = umask(0);
+    umask(mask);
+    if (fchmod(fd, (S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH) & ~mask)
+        < 0) {
+        crm_perror(LOG_WARNING, "Could not set permissions of %s", tmp_file);
+    }
+
+    rc = write_xml_fd(input, tmp_file, fd, TRUE); // This closes fd
+    if (rc < 0) {
+        rc = pcmk_legacy2rc(rc);
+        crm_err("Could not save scheduler input to %s: %s",
+                filename, pcmk_rc_str(rc));
+        unlink(tmp_file);
+
+    } else if (rename(tmp_file, filename) < 0) {
+        rc = errno;
+        crm_err("Could not rename %s to %s: %s",
+                tmp_file, filename, pcmk_rc_str(rc));
+        unlink(tmp_file);
+
+    } else {
+        rc = pcmk_rc_ok;
+    }
+    free(tmp_file);
+    return rc;
+}
+
+/*!
+ * \internal
+ * \brief Save a scheduler input to disk, in a child process if possible
+ *
+ * Compressing and syncing a large input can take long enough to noticeably
+ * delay the next scheduler run, so do it in a forked child (which has its own
+ * copy of the input, so it doesn't need to be copied here).
+ *
+ * \param[in] input     Scheduler input XML to save
+ * \param[in] filename  Where to save \p input
+ */
+static void
+save_input(xmlNode *input, const char *filename)
+{
+    pid_t pid = 0;
+    int bb_state = 0;
+
+    if (active_input_writers >= MAX_INPUT_WRITERS) {
+        crm_debug("Saving scheduler input to %s synchronously "
+                  "(%d saves already in progress)",
+                  filename, active_input_writers);
+        write_input(input, filename);
+        return;
+    }
+
+    /* Turn the blackbox off before the fork(), so the child doesn't write to
+     * the same shared memory (see write_cib_contents() in pacemaker-based)
+     */
+    bb_state = qb_log_ctl(QB_LOG_BLACKBOX, QB_LOG_CONF_STATE_GET, 0);
+    qb_log_ctl(QB_LOG_BLACKBOX, QB_LOG_CONF_ENABLED, QB_FALSE);
+
+    pid = fork();
+    if (pid == 0) {
+        int rc = write_input(input, filename);
+
+        // Use _exit() because exit() could affect the parent adversely
+        _exit((rc == pcmk_rc_ok)? CRM_EX_OK : CRM_EX_CANTCREAT);
+    }
+
+    if (bb_state == QB_LOG_STATE_ENABLED) {
+        qb_log_ctl(QB_LOG_BLACKBOX, QB_LOG_CONF_ENABLED, QB_TRUE);
+    }
+
+    if (pid < 0) {
+        crm_perror(LOG_WARNING,
+                   "Saving scheduler input to %s synchronously after "
+                   "fork failure", filename);
+        write_input(input, filename);
+        return;
+    }
+
+    active_input_writers++;
+    mainloop_child_add(pid, 0, "input-writer", strdup(filename),
+                       input_write_complete);
+}
+
 static void
 handle_pecalc_op(xmlNode *msg, xmlNode *xml_data, pcmk__client_t *sender)
 {
@@ -52,16 +266,16 @@ handle_pecalc_op(xmlNode *msg, xmlNode *xml_data, pcmk__client_t *sender)
         { "pe-warn",  "pe-warn-series-max",  5000 },
         { "pe-input", "pe-input-series-max", 4000 },
     };
-    static char *last_digest = NULL;
     static char *filename = NULL;
 
-    unsigned int seq;
+    unsigned int seq = 0;
     int series_id = 0;
     int series_wrap = 0;
     char *digest = NULL;
     const char *value = NULL;
     time_t execution_date = time(NULL);
     xmlNode *converted = NULL;
+    xmlNode *graph = NULL;
     xmlNode *reply = NULL;
     bool is_repoke = false;
     bool process = true;
@@ -69,6 +283,28 @@ handle_pecalc_op(xmlNode *msg, xmlNode *xml_data, pcmk__client_t *sender)
 
     digest = calculate_xml_versioned_digest(xml_data, FALSE, FALSE,
                                             CRM_FEATURE_SET);
+
+    if (pcmk__str_eq(digest, last_result.digest, pcmk__str_casei)
+        && (last_result.graph != NULL)
+        && ((last_result.recheck_by == 0)
+            || (execution_date < last_result.recheck_by))) {
+
+        crm_debug("Input has not changed since last time, "
+                  "reusing previously calculated transition");
+        is_repoke = true;
+        free(digest);
+
+        graph = last_result.graph;
+        pcmk__renumber_graph(graph);
+        was_processing_error = last_result.processing_error;
+        was_processing_warning = last_result.processing_warning;
+        crm_config_error = last_result.config_error;
+        crm_config_warning = last_result.config_warning;
+        series_id = last_result.series_id;
+        series_wrap = last_result.series_wrap;
+        goto reply;
+    }
+
     converted = copy_xml(xml_data);
     if (!cli_config_update(&converted, NULL, TRUE)) {
         data_set->graph = create_xml_node(NULL, XML_TAG_GRAPH);
@@ -77,13 +313,14 @@ handle_pecalc_op(xmlNode *msg, xmlNode *xml_data, pcmk__client_t *sender)
         process = false;
         free(digest);
 
-    } else if (pcmk__str_eq(digest, last_digest, pcmk__str_casei)) {
+    } else if (pcmk__str_eq(digest, last_result.digest, pcmk__str_casei)) {
         is_repoke = true;
         free(digest);
+        clear_last_result(true);
 
     } else {
-        free(last_digest);
-        last_digest = digest;
+        clear_last_result(false);
+        last_result.digest = digest;
     }
 
     if (process) {
@@ -108,16 +345,32 @@ handle_pecalc_op(xmlNode *msg, xmlNode *xml_data, pcmk__client_t *sender)
         series_wrap = series[series_id].wrap;
     }
 
-    if (pcmk__read_series_sequence(PE_STATE_DIR, series[series_id].name,
-                                   &seq) != pcmk_rc_ok) {
+    graph = data_set->graph;
+    if (process && result_is_reusable(converted)) {
+        // Keep the graph for identical input received later
+        last_result.graph = data_set->graph;
+        data_set->graph = NULL;
+        last_result.recheck_by = data_set->recheck_by;
+        last_result.series_id = series_id;
+        last_result.series_wrap = series_wrap;
+        last_result.processing_error = was_processing_error;
+        last_result.processing_warning = was_processing_warning;
+        last_result.config_error = crm_config_error;
+        last_result.config_warning = crm_config_warning;
+    }
+
+  reply:
+    if (!is_repoke && (series_wrap != 0)
+        && (pcmk__read_series_sequence(PE_STATE_DIR, series[series_id].name,
+                                       &seq) != pcmk_rc_ok)) {
         // @TODO maybe handle errors better ...
         seq = 0;
     }
     crm_trace("Series %s: wrap=%d, seq=%u, pref=%s",
-              series[series_id].name, series_wrap, seq, value);
+              series[series_id].name, series_wrap, seq, crm_str(value));
 
     data_set->input = NULL;
-    reply = create_reply(msg, data_set->graph);
+    reply = create_reply(msg, graph);
     CRM_ASSERT(reply != NULL);
 
     if (series_wrap == 0) { // Don't save any inputs of this kind
@@ -150,7 +403,7 @@ handle_pecalc_op(xmlNode *msg, xmlNode *xml_data, pcmk__client_t *sender)
                 graph_file);
 
         crm_xml_add(reply, F_CRM_TGRAPH, graph_file);
-        write_xml_fd(data_set->graph, graph_file, graph_file_fd, FALSE);
+        write_xml_fd(graph, graph_file, graph_file_fd, FALSE);
 
         free(graph_file);
         free_xml(first_named_child(reply, F_CRM_DATA));
@@ -170,7 +423,7 @@ handle_pecalc_op(xmlNode *msg, xmlNode *xml_data, pcmk__client_t *sender)
     } else {
         unlink(filename);
         crm_xml_add_ll(xml_data, "execution-date", (long long) execution_date);
-        write_xml_file(xml_data, filename, TRUE);
+        save_input(xml_data, filename);
         pcmk__write_series_sequence(PE_STATE_DIR, series[series_id].name,
                                     ++seq, series_wrap);
     }
@@ -63,6 +63,8 @@ enum cib_call_options {
     cib_zero_copy       = 0x00004000,
     cib_inhibit_notify  = 0x00010000,
     cib_quorum_override = 0x00100000,
+    //! Add the request to the connection's transaction instead of sending it
+    cib_transaction     = 0x00400000,
     cib_inhibit_bcast   = 0x01000000, //!< \deprecated Will be removed in future
     cib_force_diff      = 0x10000000
 };
@@ -129,6 +131,59 @@ typedef struct cib_api_operations_s {
                                        void (*callback)(xmlNode *, int, int,
                                                         xmlNode *, void *),
                                        void (*free_func)(void *));
+
+    /*!
+     * \brief Limit diff notifications to changes within a CIB element
+     *
+     * \param[in] cib      CIB connection
+     * \param[in] path     Absolute path of CIB element, in the form used by
+     *                     patchset changes (for example,
+     *                     "/cib/status/node_state[@id='1']")
+     * \param[in] enabled  If nonzero add \p path as a filter, otherwise remove it
+     *
+     * \return Legacy Pacemaker return code
+     * \note Once any filter is set, the connection gets only diff notifications
+     *       with a change that could affect an element it has a filter for.
+     *       Diffs in the legacy (v1) patchset format are always sent.
+     * \note A step of \p path without an ID predicate matches elements of that
+     *       name with any ID, so "/cib/status/node_state/lrm" matches changes
+     *       to the lrm section of every node's state. Removing a filter
+     *       requires the same path that was added.
+     */
+    int (*set_diff_filter)(cib_t *cib, const char *path, int enabled);
+
+    /*!
+     * \brief Start a transaction on a CIB connection
+     *
+     * Until the transaction is ended, create, modify, update, and remove
+     * requests made with the \c cib_transaction call option are queued
+     * locally rather than sent.
+     *
+     * \param[in] cib  CIB connection
+     *
+     * \return Legacy Pacemaker return code
+     * \note Nothing in Pacemaker itself uses transactions yet. The attribute
+     *       manager batches its writes as a single status section modify
+     *       instead, which older CIB managers also understand.
+     */
+    int (*init_transaction)(cib_t *cib);
+
+    /*!
+     * \brief End a transaction on a CIB connection
+     *
+     * \param[in] cib           CIB connection
+     * \param[in] commit        If TRUE, send the queued requests as a single
+     *                          request, otherwise discard them
+     * \param[in] call_options  Group of enum cib_call_options flags for the
+     *                          commit request
+     *
+     * \return Legacy Pacemaker return code for synchronous or discarded
+     *         transactions, otherwise the call ID of the commit request
+     * \note The queued requests are applied atomically, producing a single
+     *       patchset and diff notification. If the transaction is empty,
+     *       nothing is sent and pcmk_ok is returned.
+     */
+    int (*end_transaction)(cib_t *cib, gboolean commit, int call_options);
 } cib_api_operations_t;
 
 struct cib_s {
@@ -145,6 +200,8 @@ struct cib_s {
     void (*op_callback) (const xmlNode *msg, int call_id, int rc,
                          xmlNode *output);
     cib_api_operations_t *cmds;
+
+    xmlNode *transaction;   // Requests queued by the current transaction
 };
 
 #ifdef __cplusplus
@@ -29,6 +29,9 @@
 #  define CIB_OP_APPLY_DIFF "cib_apply_diff"
 #  define CIB_OP_UPGRADE    "cib_upgrade"
 #  define CIB_OP_DELETE_ALT	"cib_delete_alt"
+#  define CIB_OP_TRANSACTION	"cib_commit_transaction"
+
+#  define XML_TAG_CIB_TRANSACTION	"cib_transaction"
 
 #  define F_CIB_CLIENTID  "cib_clientid"
 #  define F_CIB_CALLOPTS  "cib_callopt"
@@ -53,6 +56,7 @@
 #  define F_CIB_CLIENTNAME	"cib_clientname"
 #  define F_CIB_NOTIFY_TYPE	"cib_notify_type"
 #  define F_CIB_NOTIFY_ACTIVATE	"cib_notify_activate"
+#  define F_CIB_NOTIFY_PATH	"cib_notify_path"
 #  define F_CIB_UPDATE_DIFF	"cib_update_diff"
 #  define F_CIB_USER		"cib_user"
 #  define F_CIB_LOCAL_NOTIFY_ID	"cib_local_notify_id"
@@ -67,6 +71,8 @@
 #  define T_CIB_POST_NOTIFY	"cib_post_notify"
 #  define T_CIB_UPDATE_CONFIRM	"cib_update_confirmation"
 #  define T_CIB_REPLACE_NOTIFY	"cib_refresh_notify"
+/* not a notification itself, but a filter on T_CIB_DIFF_NOTIFY */
+#  define T_CIB_DIFF_FILTER	"cib_diff_filter"
 
 enum cib_change_section_info {
     cib_change_section_none     = 0x00000000,
@@ -184,6 +190,29 @@ int cib_process_upgrade(const char *op, int options, const char *section, xmlNod
                         xmlNode * input, xmlNode * existing_cib, xmlNode ** result_cib,
                         xmlNode ** answer);
 
+/*!
+ * \internal
+ * \brief Apply all requests in a CIB transaction
+ *
+ * \param[in]     op            CIB_OP_TRANSACTION
+ * \param[in]     options       Flag set of \c cib_call_options
+ * \param[in]     section       If not NULL, section every request must be for
+ * \param[in]     req           Request for the transaction as a whole
+ * \param[in]     input         Transaction (XML_TAG_CIB_TRANSACTION) to apply
+ * \param[in]     existing_cib  Input CIB
+ * \param[in,out] result_cib    CIB copy to make changes in
+ * \param[out]    answer        Output of the first failed request, if any
+ *
+ * \return Legacy Pacemaker return code
+ * \note Requests are applied in order, stopping at the first failure, so that
+ *       the caller can discard the result as a whole.
+ */
+int cib_process_transaction(const char *op, int options, const char *section,
+                            xmlNode *req, xmlNode *input, xmlNode *existing_cib,
+                            xmlNode **result_cib, xmlNode **answer);
+
+bool cib__op_allowed_in_transaction(const char *op);
+
 /*!
  * \internal
  * \brief Query or modify a CIB
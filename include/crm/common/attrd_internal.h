@@ -1,5 +1,5 @@
 /*
- * Copyright 2004-2021 the Pacemaker project contributors
+ * Copyright 2004-2022 the Pacemaker project contributors
  *
  * The version control history for this file may have further details.
  *
@@ -35,6 +35,11 @@ int pcmk__node_attr_request(crm_ipc_t * ipc, char command, const char *host,
                             const char *dampen, const char *user_name,
                             int options);
 
+int pcmk__node_attr_update_list(crm_ipc_t *ipc, const char *host,
+                                GSList *attrs, const char *section,
+                                const char *set, const char *dampen,
+                                const char *user_name, int options);
+
 int pcmk__node_attr_request_clear(crm_ipc_t *ipc, const char *host,
                                   const char *resource, const char *operation,
                                   const char *interval_spec,
@@ -146,6 +146,8 @@ enum crm_ipc_flags
     crm_ipc_flags_none      = 0x00000000,
 
     crm_ipc_compressed      = 0x00000001, /* Message has been compressed */
+    crm_ipc_multipart       = 0x00000002, /* Message is one part of a larger message */
+    crm_ipc_multipart_end   = 0x00000004, /* Message is the last part of a larger message */
 
     crm_ipc_proxied         = 0x00000100, /* _ALL_ replies to proxied connections need to be sent as events */
     crm_ipc_client_response = 0x00000200, /* A Response is expected in reply */
@@ -157,6 +157,11 @@ struct pcmk__client_s {
 
     unsigned int queue_backlog; /* IPC queue length after last flush */
     unsigned int queue_max;     /* Evict client whose queue grows this big */
+
+    char *multipart;            /* IPC request being reassembled from parts */
+    unsigned int multipart_len; /* Bytes of multipart request received */
+    GQueue *response_queue;     /* IPC response parts not yet sent */
+    uint32_t event_offset;      /* Bytes of queued multipart event sent */
 };
 
 #define pcmk__set_client_flags(client, flags_to_set) do {               \
@@ -217,6 +222,9 @@ int pcmk__ipc_send_ack_as(const char *function, int line, pcmk__client_t *c,
 int pcmk__ipc_prepare_iov(uint32_t request, xmlNode *message,
                           uint32_t max_send_size,
                           struct iovec **result, ssize_t *bytes);
+struct iovec *pcmk__ipc_multipart_iov(const struct iovec *iov,
+                                      uint32_t max_send_size,
+                                      uint32_t *offset);
 int pcmk__ipc_send_xml(pcmk__client_t *c, uint32_t request, xmlNode *message,
                        uint32_t flags);
 int pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags);
@@ -310,6 +310,77 @@ pcmk__xe_first_attr(const xmlNode *xe)
 char *
 pcmk__xpath_node_id(const char *xpath, const char *node);
 
+bool pcmk__xpath_within(const char *path, const char *ancestor);
+
+//! Operations a v2 patchset change can perform
+enum pcmk__patch_op {
+    pcmk__patch_op_unknown,
+    pcmk__patch_op_create,
+    pcmk__patch_op_modify,
+    pcmk__patch_op_delete,
+    pcmk__patch_op_move,
+};
+
+//! One step of the path to the element a v2 patchset change applies to
+typedef struct {
+    const char *tag;    //!< Element name
+    const char *id;     //!< Element ID, or NULL if the step doesn't select one
+} pcmk__patch_step_t;
+
+//! Change from a v2 patchset, with its path parsed
+typedef struct {
+    enum pcmk__patch_op op;     //!< What the change does
+    const char *op_name;        //!< Operation as given in the patchset
+    const char *path;           //!< Path as given (NULL for version changes)
+    pcmk__patch_step_t *steps;  //!< Parsed path (NULL if none or malformed)
+    int n_steps;                //!< Number of entries in \c steps
+    xmlNode *change;            //!< Change XML in the patchset
+    xmlNode *result;            //!< Created or modified XML (if any)
+    char *buffer;               // Storage for strings in steps
+} pcmk__patch_change_t;
+
+int pcmk__patchset_changes(xmlNode *patchset, pcmk__patch_change_t **changes,
+                           int *n_changes);
+void pcmk__free_patchset_changes(pcmk__patch_change_t *changes, int n_changes);
+
+/*!
+ * \internal
+ * \brief Find the first step of a patchset change's path with a given tag
+ *
+ * \param[in] change  Parsed patchset change
+ * \param[in] tag     Element name to search for
+ *
+ * \return First step of \p change's path for \p tag elements, or NULL if none
+ */
+static inline const pcmk__patch_step_t *
+pcmk__patch_change_step(const pcmk__patch_change_t *change, const char *tag)
+{
+    for (int i = 0; i < change->n_steps; i++) {
+        if (strcmp(change->steps[i].tag, tag) == 0) {
+            return &(change->steps[i]);
+        }
+    }
+    return NULL;
+}
+
+/*!
+ * \internal
+ * \brief Get the ID selected for a given tag in a patchset change's path
+ *
+ * \param[in] change  Parsed patchset change
+ * \param[in] tag     Element name to search for
+ *
+ * \return ID in the first step of \p change's path for \p tag elements, or
+ *         NULL if there is no such step or it doesn't select an ID
+ */
+static inline const char *
+pcmk__patch_change_id(const pcmk__patch_change_t *change, const char *tag)
+{
+    const pcmk__patch_step_t *step = pcmk__patch_change_step(change, tag);
+
+    return (step == NULL)? NULL : step->id;
+}
+
 /* internal XML-related utilities */
 
 enum xml_private_flags {
@@ -584,6 +584,10 @@ void pe__update_expected_node(pe_resource_t *rsc, pe_node_t *node,
                               int execution_status, int exit_status,
                               int expected_exit_status);
 
+void pe__index_resource(pe_working_set_t *data_set, pe_resource_t *rsc);
+void pe__set_clone_name(pe_resource_t *rsc, const char *clone_name);
+void pe__index_node(pe_working_set_t *data_set, pe_node_t *node);
+
 int pe__sum_node_health_scores(const pe_node_t *node, int base_health);
 int pe__node_health(pe_node_t *node);
 
@@ -197,6 +197,8 @@ struct pe_working_set_s {
     int priority_fencing_delay; // Priority fencing delay
 
     void *priv;
+
+    struct pe__ws_index_s *index; // Lookup tables (for internal use only)
 };
 
 enum pe_check_parameters {
@@ -465,6 +467,9 @@ struct pe_action_s {
      * except for API backward compatibility.
      */
     void *action_details; // varies by type of action
+
+    // Combined ordering types in actions_after, by action (internal use only)
+    GHashTable *after_types;
 };
 
 typedef struct pe_ticket_s {
@@ -51,6 +51,8 @@ void services__format_result(svc_action_t *action, int agent_status,
                              enum pcmk_exec_status exec_status,
                              const char *format, ...) G_GNUC_PRINTF(4, 5);
 
+int services__launch_coprocess(svc_action_t *op, int *fd);
+
 #  ifdef __cplusplus
 }
 #  endif
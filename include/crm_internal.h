@@ -59,6 +59,7 @@
  */
 
 #define PCMK__XA_ATTR_DAMPENING         "attr_dampening"
+#define PCMK__XA_ATTR_DIGEST            "attr_digest"
 #define PCMK__XA_ATTR_FORCE             "attrd_is_force_write"
 #define PCMK__XA_ATTR_INTERVAL          "attr_clear_interval"
 #define PCMK__XA_ATTR_IS_PRIVATE        "attr_is_private"
@@ -67,6 +68,7 @@
 #define PCMK__XA_ATTR_NODE_ID           "attr_host_id"
 #define PCMK__XA_ATTR_NODE_NAME         "attr_host"
 #define PCMK__XA_ATTR_OPERATION         "attr_clear_operation"
+#define PCMK__XA_ATTR_PARTIAL           "attr_partial"
 #define PCMK__XA_ATTR_PATTERN           "attr_regex"
 #define PCMK__XA_ATTR_RESOURCE          "attr_resource"
 #define PCMK__XA_ATTR_SECTION           "attr_section"
@@ -101,6 +103,7 @@
 #define PCMK__ATTRD_CMD_FLUSH           "flush"
 #define PCMK__ATTRD_CMD_SYNC            "sync"
 #define PCMK__ATTRD_CMD_SYNC_RESPONSE   "sync-response"
+#define PCMK__ATTRD_CMD_SYNC_DIGESTS    "sync-digests"
 #define PCMK__ATTRD_CMD_CLEAR_FAILURE   "clear-failure"
 
 #define PCMK__CONTROLD_CMD_NODES        "list-nodes"
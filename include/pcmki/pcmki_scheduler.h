@@ -60,9 +60,47 @@ struct rsc_ticket_s {
 
 void pcmk__unpack_constraints(pe_working_set_t *data_set);
 
+// Scheduler phases that can be profiled
+enum pcmk__sched_phase {
+    pcmk__phase_unpack_cib,
+    pcmk__phase_node_health,
+    pcmk__phase_unpack_constraints,
+    pcmk__phase_node_criteria,
+    pcmk__phase_internal_constraints,
+    pcmk__phase_config_changes,
+    pcmk__phase_allocate,
+    pcmk__phase_resource_actions,
+    pcmk__phase_remote_orderings,
+    pcmk__phase_fencing,
+    pcmk__phase_apply_orderings,
+    pcmk__phase_create_graph,
+    pcmk__phase_max,            // Not a phase, but the number of phases
+};
+
+// Accumulated profiling information for scheduler runs
+typedef struct {
+    double wall[pcmk__phase_max];   // Elapsed seconds spent in each phase
+    double cpu[pcmk__phase_max];    // Processor seconds spent in each phase
+    long peak_rss_kb;               // Peak resident set size of process
+
+    // Object counts at the end of the most recent run
+    unsigned int resources;
+    unsigned int nodes;
+    unsigned int actions;
+    unsigned int orderings;
+    unsigned int colocations;
+    unsigned int locations;
+    unsigned int synapses;
+} pcmk__sched_profile_t;
+
+const char *pcmk__sched_phase_name(enum pcmk__sched_phase phase);
+
 extern void add_maintenance_update(pe_working_set_t *data_set);
 void pcmk__schedule_actions(xmlNode *cib, unsigned long long flags,
                             pe_working_set_t *data_set);
+void pcmk__schedule_actions_profiled(xmlNode *cib, unsigned long long flags,
+                                     pe_working_set_t *data_set,
+                                     pcmk__sched_profile_t *profile);
 
 extern const char *transition_idle_timeout;
 
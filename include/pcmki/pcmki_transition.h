@@ -43,6 +43,8 @@ typedef struct synapse_s {
 
     GList *actions;           /* crm_action_t* */
     GList *inputs;            /* crm_action_t* */
+
+    int unconfirmed_inputs;   // Number of inputs not yet confirmed
 } synapse_t;
 
 const char *synapse_state_str(synapse_t *synapse);
@@ -140,6 +142,12 @@ struct crm_graph_s {
     GList *synapses;          /* synapse_t* */
 
     int migration_limit;
+
+    // Lookup tables for synapse actions (not inputs), built when unpacking
+    GHashTable *actions_by_id;  // crm_action_t* by action ID
+    GHashTable *cancels_by_key; // GList of crm_action_t* by cancelled op key
+    GHashTable *downed_by_node; // GList of crm_action_t* by downed node UUID
+    GHashTable *inputs_by_id;   // GList of synapse inputs by action ID
 };
 
 typedef struct crm_graph_functions_s {
@@ -180,6 +180,79 @@ cib_client_erase(cib_t * cib, xmlNode ** output_data, int call_options)
     return cib_internal_op(cib, CIB_OP_ERASE, NULL, NULL, NULL, output_data, call_options, NULL);
 }
 
+static int
+cib_client_set_diff_filter(cib_t *cib, const char *path, int enabled)
+{
+    return -EPROTONOSUPPORT;
+}
+
+static int
+cib_client_init_transaction(cib_t *cib)
+{
+    op_common(cib);
+    if (cib->transaction != NULL) {
+        crm_err("Cannot start a CIB transaction: one is already in progress");
+        return -EALREADY;
+    }
+    cib->transaction = create_xml_node(NULL, XML_TAG_CIB_TRANSACTION);
+    return (cib->transaction == NULL)? -ENOMEM : pcmk_ok;
+}
+
+/*!
+ * \internal
+ * \brief Get the section common to all requests in a transaction
+ *
+ * \param[in] transaction  Transaction to check
+ *
+ * \return Section that every request in \p transaction is for, or NULL if
+ *         there is none (or any request uses an XPath)
+ */
+static const char *
+transaction_section(xmlNode *transaction)
+{
+    const char *section = NULL;
+
+    for (xmlNode *request = first_named_child(transaction, "cib_command");
+         request != NULL; request = crm_next_same_xml(request)) {
+
+        const char *request_section = crm_element_value(request,
+                                                        F_CIB_SECTION);
+        int options = cib_none;
+
+        crm_element_value_int(request, F_CIB_CALLOPTS, &options);
+        if ((request_section == NULL) || pcmk_is_set(options, cib_xpath)
+            || ((section != NULL)
+                && !pcmk__str_eq(section, request_section, pcmk__str_none))) {
+            return NULL;
+        }
+        section = request_section;
+    }
+    return section;
+}
+
+static int
+cib_client_end_transaction(cib_t *cib, gboolean commit, int call_options)
+{
+    int rc = pcmk_ok;
+
+    op_common(cib);
+    if (cib->transaction == NULL) {
+        crm_err("Cannot end a CIB transaction: none is in progress");
+        return -EINVAL;
+    }
+
+    if (commit && (cib->transaction->children != NULL)) {
+        cib__clear_call_options(call_options, "transaction", cib_transaction);
+        rc = cib_internal_op(cib, CIB_OP_TRANSACTION, NULL,
+                             transaction_section(cib->transaction),
+                             cib->transaction, NULL, call_options, NULL);
+    }
+
+    free_xml(cib->transaction);
+    cib->transaction = NULL;
+    return rc;
+}
+
 static void
 cib_destroy_op_callback(gpointer data)
 {
@@ -384,6 +457,9 @@ cib_new_variant(void)
     new_cib->cmds->del_notify_callback = cib_client_del_notify_callback;
     new_cib->cmds->register_callback = cib_client_register_callback;
     new_cib->cmds->register_callback_full = cib_client_register_callback_full;
+    new_cib->cmds->set_diff_filter = cib_client_set_diff_filter;
+    new_cib->cmds->init_transaction = cib_client_init_transaction;
+    new_cib->cmds->end_transaction = cib_client_end_transaction;
 
     new_cib->cmds->noop = cib_client_noop;
     new_cib->cmds->ping = cib_client_ping;
@@ -452,6 +528,8 @@ cib_delete(cib_t *cib)
 {
     cib_free_callbacks(cib);
     if (cib) {
+        free_xml(cib->transaction);
+        cib->transaction = NULL;
         cib->cmds->free(cib);
     }
 }
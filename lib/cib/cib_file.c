@@ -784,6 +784,7 @@ static struct cib_func_entry cib_file_ops[] = {
     {CIB_OP_DELETE,     FALSE, cib_process_delete},
     {CIB_OP_ERASE,      FALSE, cib_process_erase},
     {CIB_OP_UPGRADE,    FALSE, cib_process_upgrade},
+    {CIB_OP_TRANSACTION, FALSE, cib_process_transaction},
 };
 /* *INDENT-ON* */
 
@@ -51,6 +51,8 @@ int cib_native_signon(cib_t * cib, const char *name, enum cib_conn_type type);
 int cib_native_signon_raw(cib_t * cib, const char *name, enum cib_conn_type type, int *event_fd);
 
 int cib_native_set_connection_dnotify(cib_t * cib, void (*dnotify) (gpointer user_data));
+static int cib_native_set_diff_filter(cib_t *cib, const char *path,
+                                      int enabled);
 
 cib_t *
 cib_native_new(void)
@@ -84,6 +86,7 @@ cib_native_new(void)
     cib->cmds->free = cib_native_free;
 
     cib->cmds->register_notification = cib_native_register_notification;
+    cib->cmds->set_diff_filter = cib_native_set_diff_filter;
     cib->cmds->set_connection_dnotify = cib_native_set_connection_dnotify;
 
     return cib;
@@ -465,8 +468,9 @@ cib_native_set_connection_dnotify(cib_t * cib, void (*dnotify) (gpointer user_da
     return pcmk_ok;
 }
 
-int
-cib_native_register_notification(cib_t * cib, const char *callback, int enabled)
+static int
+register_notify(cib_t *cib, const char *callback, const char *path,
+                int enabled)
 {
     int rc = pcmk_ok;
     xmlNode *notify_msg = create_xml_node(NULL, "cib-callback");
@@ -475,6 +479,7 @@ cib_native_register_notification(cib_t * cib, const char *callback, int enabled)
     if (cib->state != cib_disconnected) {
         crm_xml_add(notify_msg, F_CIB_OPERATION, T_CIB_NOTIFY);
         crm_xml_add(notify_msg, F_CIB_NOTIFY_TYPE, callback);
+        crm_xml_add(notify_msg, F_CIB_NOTIFY_PATH, path);
         crm_xml_add_int(notify_msg, F_CIB_NOTIFY_ACTIVATE, enabled);
         rc = crm_ipc_send(native->ipc, notify_msg, crm_ipc_client_response,
                           1000 * cib->call_timeout, NULL);
@@ -487,3 +492,18 @@ cib_native_register_notification(cib_t * cib, const char *callback, int enabled)
     free_xml(notify_msg);
     return rc;
 }
+
+int
+cib_native_register_notification(cib_t * cib, const char *callback, int enabled)
+{
+    return register_notify(cib, callback, NULL, enabled);
+}
+
+static int
+cib_native_set_diff_filter(cib_t *cib, const char *path, int enabled)
+{
+    if (path == NULL) {
+        return -EINVAL;
+    }
+    return register_notify(cib, T_CIB_DIFF_FILTER, path, enabled);
+}
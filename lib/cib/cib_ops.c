@@ -599,6 +599,120 @@ cib_process_diff(const char *op, int options, const char *section, xmlNode * req
     return xml_apply_patchset(*result_cib, input, TRUE);
 }
 
+/*!
+ * \internal
+ * \brief Get the function that applies an operation within a transaction
+ *
+ * \param[in] op  CIB operation
+ *
+ * \return Function to apply \p op, or NULL if \p op is not allowed in a
+ *         transaction
+ */
+static cib_op_t
+transaction_op_fn(const char *op)
+{
+    if (pcmk__str_eq(op, CIB_OP_CREATE, pcmk__str_none)) {
+        return cib_process_create;
+    } else if (pcmk__str_eq(op, CIB_OP_MODIFY, pcmk__str_none)) {
+        return cib_process_modify;
+    } else if (pcmk__str_eq(op, CIB_OP_DELETE, pcmk__str_none)) {
+        return cib_process_delete;
+    }
+    return NULL;
+}
+
+/*!
+ * \internal
+ * \brief Check whether a CIB operation may be part of a transaction
+ *
+ * \param[in] op  CIB operation
+ *
+ * \return true if \p op can be queued in a transaction, otherwise false
+ */
+bool
+cib__op_allowed_in_transaction(const char *op)
+{
+    return transaction_op_fn(op) != NULL;
+}
+
+int
+cib_process_transaction(const char *op, int options, const char *section,
+                        xmlNode *req, xmlNode *input, xmlNode *existing_cib,
+                        xmlNode **result_cib, xmlNode **answer)
+{
+    int rc = pcmk_ok;
+    int count = 0;
+
+    crm_trace("Processing \"%s\" event", op);
+    *answer = NULL;
+
+    if (!pcmk__str_eq(crm_element_name(input), XML_TAG_CIB_TRANSACTION,
+                      pcmk__str_none)) {
+        crm_err("Cannot perform transaction with no requests");
+        return -EINVAL;
+    }
+
+    for (xmlNode *request = first_named_child(input, "cib_command");
+         request != NULL; request = crm_next_same_xml(request)) {
+
+        const char *sub_op = crm_element_value(request, F_CIB_OPERATION);
+        const char *sub_section = crm_element_value(request, F_CIB_SECTION);
+        xmlNode *data = get_message_xml(request, F_CIB_CALLDATA);
+        xmlNode *output = NULL;
+        int sub_options = cib_none;
+        cib_op_t fn = transaction_op_fn(sub_op);
+
+        count++;
+        crm_element_value_int(request, F_CIB_CALLOPTS, &sub_options);
+
+        if (fn == NULL) {
+            crm_err("Operation %s is not allowed in a transaction",
+                    crm_str(sub_op));
+            rc = -EINVAL;
+            break;
+        }
+
+        /* The section of the transaction as a whole determines how the CIB
+         * manager treats it (for example, whether the result is validated),
+         * so every request must agree with it.
+         */
+        if ((section != NULL)
+            && (pcmk_is_set(sub_options, cib_xpath)
+                || !pcmk__str_eq(section, sub_section, pcmk__str_none))) {
+            crm_err("Request %d in transaction is not for section %s",
+                    count, section);
+            rc = -EINVAL;
+            break;
+        }
+
+        /* Mirror the logic in cib_prepare_common() */
+        if ((sub_section != NULL) && (data != NULL)
+            && pcmk__str_eq(crm_element_name(data), XML_TAG_CIB,
+                            pcmk__str_none)) {
+            data = pcmk_find_cib_element(data, sub_section);
+        }
+
+        rc = fn(sub_op, sub_options, sub_section, req, data, existing_cib,
+                result_cib, &output);
+
+        if ((output != NULL) && (*result_cib != NULL)
+            && (output->doc == (*result_cib)->doc)) {
+            output = NULL; // Part of the result, not ours to free
+        }
+        if (rc != pcmk_ok) {
+            crm_info("Request %d (%s) in transaction failed: %s",
+                     count, sub_op, pcmk_strerror(rc));
+            *answer = output;
+            break;
+        }
+        free_xml(output);
+    }
+
+    crm_trace("Applied %d request%s in transaction",
+              count, pcmk__plural_s(count));
+    return rc;
+}
+
 gboolean
 cib_config_changed(xmlNode * last, xmlNode * next, xmlNode ** diff)
 {
@@ -87,19 +87,36 @@ cib_remote_set_connection_dnotify(cib_t * cib, void (*dnotify) (gpointer user_da
 }
 
 static int
-cib_remote_register_notification(cib_t * cib, const char *callback, int enabled)
+register_notify(cib_t *cib, const char *callback, const char *path,
+                int enabled)
 {
     xmlNode *notify_msg = create_xml_node(NULL, "cib_command");
     cib_remote_opaque_t *private = cib->variant_opaque;
 
     crm_xml_add(notify_msg, F_CIB_OPERATION, T_CIB_NOTIFY);
     crm_xml_add(notify_msg, F_CIB_NOTIFY_TYPE, callback);
+    crm_xml_add(notify_msg, F_CIB_NOTIFY_PATH, path);
     crm_xml_add_int(notify_msg, F_CIB_NOTIFY_ACTIVATE, enabled);
     pcmk__remote_send_xml(&private->callback, notify_msg);
     free_xml(notify_msg);
     return pcmk_ok;
 }
 
+static int
+cib_remote_register_notification(cib_t * cib, const char *callback, int enabled)
+{
+    return register_notify(cib, callback, NULL, enabled);
+}
+
+static int
+cib_remote_set_diff_filter(cib_t *cib, const char *path, int enabled)
+{
+    if (path == NULL) {
+        return -EINVAL;
+    }
+    return register_notify(cib, T_CIB_DIFF_FILTER, path, enabled);
+}
+
 cib_t *
 cib_remote_new(const char *server, const char *user, const char *passwd, int port,
                gboolean encrypted)
@@ -136,6 +153,7 @@ cib_remote_new(const char *server, const char *user, const char *passwd, int por
     cib->cmds->inputfd = cib_remote_inputfd;
 
     cib->cmds->register_notification = cib_remote_register_notification;
+    cib->cmds->set_diff_filter = cib_remote_set_diff_filter;
     cib->cmds->set_connection_dnotify = cib_remote_set_connection_dnotify;
 
     return cib;
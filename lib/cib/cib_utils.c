@@ -141,6 +141,210 @@ cib_acl_enabled(xmlNode *xml, const char *user)
     return rc;
 }
 
+/*!
+ * \internal
+ * \brief Check whether a CIB modification is confined to the configuration
+ *
+ * \param[in] op            CIB operation name
+ * \param[in] call_options  Group of enum cib_call_options flags
+ * \param[in] section       CIB section the operation applies to
+ * \param[in] input         Operation input XML
+ *
+ * \return true if \p op can't touch anything outside the configuration
+ *         section of the CIB (and the CIB it applies to is discarded on
+ *         success), otherwise false
+ */
+static bool
+op_is_config_only(const char *op, int call_options, const char *section,
+                  xmlNode *input)
+{
+    if (pcmk_any_flags_set(call_options, cib_xpath|cib_dryrun)
+        || (input == NULL)
+        || pcmk__str_eq(crm_element_name(input), XML_TAG_CIB, pcmk__str_casei)
+        || !pcmk__str_any_of(op, CIB_OP_CREATE, CIB_OP_MODIFY, CIB_OP_DELETE,
+                             CIB_OP_REPLACE, CIB_OP_TRANSACTION, NULL)) {
+        return false;
+    }
+
+    if (pcmk__str_eq(section, XML_CIB_TAG_CONFIGURATION, pcmk__str_none)) {
+        return true;
+    }
+    return (section != NULL)
+           && pcmk__str_eq(pcmk_cib_parent_name_for(section),
+                           "/" XML_TAG_CIB "/" XML_CIB_TAG_CONFIGURATION,
+                           pcmk__str_none);
+}
+
+/*!
+ * \internal
+ * \brief Unlink the status section from a CIB, if it can be moved cheaply
+ *
+ * \param[in] cib  CIB XML to remove status section from
+ *
+ * \return Unlinked status section, or NULL if it was left in place
+ * \note The status section is only unlinked if it is the last child of \p cib,
+ *       so that it can be put back without having to remember its position.
+ */
+static xmlNode *
+detach_status(xmlNode *cib)
+{
+    xmlNode *status = NULL;
+    const char *version = crm_element_value(cib, XML_ATTR_CRM_VERSION);
+
+    /* The changes for a v1 patchset are calculated by comparing the full old
+     * and new CIBs, so both must have a status section.
+     */
+    if (compare_version("3.0.8", version) >= 0) {
+        return NULL;
+    }
+
+    status = first_named_child(cib, XML_CIB_TAG_STATUS);
+    if ((status == NULL) || (status->next != NULL)) {
+        return NULL;
+    }
+
+    xmlUnlinkNode(status);
+    return status;
+}
+
+/*!
+ * \internal
+ * \brief Give a status section moved by detach_status() back to its CIB
+ *
+ * \param[in,out] cib     CIB XML that status section was removed from
+ * \param[in,out] status  Status section to put back (will be set to NULL)
+ */
+static void
+reattach_status(xmlNode *cib, xmlNode **status)
+{
+    if (*status != NULL) {
+        xmlUnlinkNode(*status);
+        xmlAddChild(cib, *status);
+        *status = NULL;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Check whether a patchset path is within the CIB status section
+ *
+ * \param[in] path  Path from a v2 patchset change
+ *
+ * \return true if \p path is the status section or an element within it
+ */
+static bool
+path_in_status(const char *path)
+{
+    static const char *status_path = "/" XML_TAG_CIB "/" XML_CIB_TAG_STATUS;
+    static size_t status_len = sizeof("/" XML_TAG_CIB "/" XML_CIB_TAG_STATUS) - 1;
+
+    return (path != NULL) && (strncmp(path, status_path, status_len) == 0)
+           && ((path[status_len] == '\0') || (path[status_len] == '/')
+               || (path[status_len] == '['));
+}
+
+/*!
+ * \internal
+ * \brief Check whether a CIB patchset could affect the CIB's schema validity
+ *
+ * Every schema accepts anything inside the status section, so a change there
+ * can't make a valid CIB invalid. The same goes for the update counter that
+ * accompanies status changes.
+ *
+ * \param[in] patchset  Patchset describing a CIB modification
+ *
+ * \return false if \p patchset is in v2 format and changes nothing but the
+ *         contents of the status section and the update counter, otherwise
+ *         true
+ */
+static bool
+patchset_affects_schema(xmlNode *patchset)
+{
+    int format = 1;
+
+    if (patchset == NULL) {
+        return true;
+    }
+    crm_element_value_int(patchset, "format", &format);
+    if (format != 2) {
+        return true;
+    }
+
+    for (xmlNode *change = first_named_child(patchset, XML_DIFF_CHANGE);
+         change != NULL; change = crm_next_same_xml(change)) {
+
+        const char *op = crm_element_value(change, XML_DIFF_OP);
+        const char *path = crm_element_value(change, XML_DIFF_PATH);
+
+        if (path_in_status(path)) {
+            // The status section itself is required
+            if (pcmk__str_eq(op, "delete", pcmk__str_none)
+                && pcmk__str_eq(path, "/" XML_TAG_CIB "/" XML_CIB_TAG_STATUS,
+                                pcmk__str_none)) {
+                return true;
+            }
+            continue;
+        }
+
+        if (pcmk__str_eq(op, "modify", pcmk__str_none)
+            && pcmk__str_eq(path, "/" XML_TAG_CIB, pcmk__str_none)) {
+            xmlNode *list = first_named_child(change, XML_DIFF_LIST);
+
+            for (xmlNode *attr = first_named_child(list, XML_DIFF_ATTR);
+                 attr != NULL; attr = crm_next_same_xml(attr)) {
+
+                if (!pcmk__str_eq(crm_element_value(attr, XML_NVPAIR_ATTR_NAME),
+                                  XML_ATTR_NUMUPDATES, pcmk__str_none)) {
+                    return true;
+                }
+            }
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * \internal
+ * \brief Validate a CIB against its schema without its status section content
+ *
+ * Every schema accepts anything inside the status section, which is usually
+ * the largest part of the CIB, so validate a copy with an empty status
+ * section instead.
+ *
+ * \param[in] cib  CIB XML to validate
+ *
+ * \return TRUE if \p cib is valid, otherwise FALSE
+ */
+static gboolean
+validate_cib(xmlNode *cib)
+{
+    gboolean valid = FALSE;
+    xmlNode *copy = NULL;
+    xmlNode *status = first_named_child(cib, XML_CIB_TAG_STATUS);
+
+    if ((status == NULL) || (status->children == NULL)) {
+        return validate_xml(cib, NULL, TRUE);
+    }
+
+    copy = create_xml_node(NULL, (const char *) cib->name);
+    copy_in_properties(copy, cib);
+    for (xmlNode *child = cib->children; child != NULL; child = child->next) {
+        if (child == status) {
+            xmlNode *empty = create_xml_node(copy, XML_CIB_TAG_STATUS);
+
+            copy_in_properties(empty, status);
+        } else {
+            add_node_copy(copy, child);
+        }
+    }
+
+    valid = validate_xml(copy, NULL, TRUE);
+    free_xml(copy);
+    return valid;
+}
+
 int
 cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_query,
                const char *section, xmlNode * req, xmlNode * input,
@@ -151,6 +355,7 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
     gboolean check_schema = TRUE;
     xmlNode *top = NULL;
     xmlNode *scratch = NULL;
+    xmlNode *status = NULL;
     xmlNode *local_diff = NULL;
 
     const char *new_version = NULL;
@@ -217,6 +422,17 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
     }
 
 
+    if (diff_cs == NULL) {
+        diff_cs = qb_log_callsite_get(__PRETTY_FUNCTION__, __FILE__, "diff-validation", LOG_DEBUG, __LINE__, crm_trace_nonlog);
+    }
+
+    /* A failed transaction may have applied some of its requests already, so
+     * it must never be performed on the current CIB in place
+     */
+    if (pcmk__str_eq(op, CIB_OP_TRANSACTION, pcmk__str_none)) {
+        cib__clear_call_options(call_options, "transaction", cib_zero_copy);
+    }
+
     if (pcmk_is_set(call_options, cib_zero_copy)) {
         /* Conditional on v2 patch style */
 
@@ -231,8 +447,29 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
         rc = (*fn) (op, call_options, section, req, input, scratch, &scratch, output);
 
     } else {
+        bool acl_enabled = cib_acl_enabled(current_cib, user);
+
+        /* The status section is usually by far the largest part of the CIB,
+         * and an operation confined to the configuration can't change it.
+         * Rather than copying it, move it over to the new CIB (which replaces
+         * the current one on success), and give it back if the update fails.
+         *
+         * This isn't done when ACLs apply (tracking would leave ACL flags on
+         * the moved nodes), or when calculated patchsets are being validated
+         * (that needs a complete copy of the original CIB).
+         */
+        if (!acl_enabled && op_is_config_only(op, call_options, section, input)
+            && !crm_is_callsite_active(diff_cs, LOG_TRACE, 0)) {
+            status = detach_status(current_cib);
+        }
+
         scratch = copy_xml(current_cib);
-        xml_track_changes(scratch, user, NULL, cib_acl_enabled(scratch, user));
+        if (status != NULL) {
+            crm_trace("Moving status section to new CIB for %s op", op);
+            xmlAddChild(scratch, status);
+        }
+
+        xml_track_changes(scratch, user, NULL, acl_enabled);
         rc = (*fn) (op, call_options, section, req, input, current_cib, &scratch, output);
 
         if(scratch && xml_tracking_changes(scratch) == FALSE) {
@@ -240,7 +477,8 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
             xml_track_changes(scratch, user, current_cib, cib_acl_enabled(current_cib, user));
             xml_calculate_changes(current_cib, scratch);
         }
-        CRM_CHECK(current_cib != scratch, return -EINVAL);
+        CRM_CHECK(current_cib != scratch,
+                  reattach_status(current_cib, &status); return -EINVAL);
     }
 
     xml_acl_disable(scratch); /* Allow the system to make any additional changes */
@@ -323,10 +561,6 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
     xml_log_changes(LOG_TRACE, __func__, scratch);
     xml_accept_changes(scratch);
 
-    if (diff_cs == NULL) {
-        diff_cs = qb_log_callsite_get(__PRETTY_FUNCTION__, __FILE__, "diff-validation", LOG_DEBUG, __LINE__, crm_trace_nonlog);
-    }
-
     if(local_diff) {
         patchset_process_digest(local_diff, current_cib, scratch, with_digest);
 
@@ -361,6 +595,11 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
          * b) we don't validate any of its contents at the moment anyway
          */
         check_schema = FALSE;
+
+    } else if (!patchset_affects_schema(local_diff)) {
+        // Same reasoning for updates found to touch only the status section
+        crm_trace("Skipping validation of status-only %s op", op);
+        check_schema = FALSE;
     }
 
     /* === scratch must not be modified after this point ===
@@ -401,7 +640,7 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
     }
 
     crm_trace("Perform validation: %s", pcmk__btoa(check_schema));
-    if ((rc == pcmk_ok) && check_schema && !validate_xml(scratch, NULL, TRUE)) {
+    if ((rc == pcmk_ok) && check_schema && !validate_cib(scratch)) {
         const char *current_schema = crm_element_value(scratch,
                                                        XML_ATTR_VALIDATION);
 
@@ -412,6 +651,19 @@ cib_perform_op(const char *op, int call_options, cib_op_t * fn, gboolean is_quer
 
   done:
 
+    if ((status != NULL) && (rc != pcmk_ok)) {
+        /* The current CIB stays in use, so it gets its status section back.
+         * Callers may still want to see the full rejected CIB (for example,
+         * to report schema validation errors), so that gets a copy.
+         */
+        xmlNode *moved = status;
+
+        reattach_status(current_cib, &status);
+        if (scratch != NULL) {
+            add_node_copy(scratch, moved);
+        }
+    }
+
     *result_cib = scratch;
     if(rc != pcmk_ok && cib_acl_enabled(current_cib, user)) {
         if(xml_acl_filtered_copy(user, current_cib, scratch, result_cib)) {
@@ -641,6 +893,47 @@ cib_internal_config_changed(xmlNode *diff)
     return changed;
 }
 
+/*!
+ * \internal
+ * \brief Queue a request in a CIB connection's transaction
+ *
+ * \param[in] cib           CIB connection with a transaction in progress
+ * \param[in] op            CIB operation to queue
+ * \param[in] host          Must be NULL (requests can't be targeted)
+ * \param[in] section       Section (or XPath) that \p op applies to
+ * \param[in] data          Request data (copied)
+ * \param[in] call_options  Group of enum cib_call_options flags for request
+ *
+ * \return Legacy Pacemaker return code
+ */
+static int
+extend_transaction(cib_t *cib, const char *op, const char *host,
+                   const char *section, xmlNode *data, int call_options)
+{
+    xmlNode *request = NULL;
+
+    if (cib->transaction == NULL) {
+        crm_err("Cannot queue %s request: no transaction in progress", op);
+        return -EINVAL;
+    }
+    if ((host != NULL) || !cib__op_allowed_in_transaction(op)) {
+        crm_err("Cannot queue %s request%s%s in a transaction", op,
+                ((host == NULL)? "" : " for "), crm_str(host));
+        return -EOPNOTSUPP;
+    }
+
+    cib__clear_call_options(call_options, "transaction", cib_transaction);
+
+    request = create_xml_node(cib->transaction, "cib_command");
+    crm_xml_add(request, F_CIB_OPERATION, op);
+    crm_xml_add(request, F_CIB_SECTION, section);
+    crm_xml_add_int(request, F_CIB_CALLOPTS, call_options);
+    if (data != NULL) {
+        add_message_xml(request, F_CIB_CALLDATA, data);
+    }
+    return pcmk_ok;
+}
+
 int
 cib_internal_op(cib_t * cib, const char *op, const char *host,
                 const char *section, xmlNode * data,
@@ -655,6 +948,10 @@ cib_internal_op(cib_t * cib, const char *op, const char *host,
         user_name = getenv("CIB_user");
     }
 
+    if (pcmk_is_set(call_options, cib_transaction)) {
+        return extend_transaction(cib, op, host, section, data, call_options);
+    }
+
     return delegate(cib, op, host, section, data, output_data, call_options, user_name);
 }
 
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2022 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU Lesser General Public License
+ * version 2.1 or later (LGPLv2.1+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <crm/msg_xml.h>
+#include <crm/cib/internal.h>
+
+#define CIB_XML                                                             \
+    "<" XML_TAG_CIB " " XML_ATTR_VALIDATION "=\"none\" "                   \
+        XML_ATTR_CRM_VERSION "=\"" CRM_FEATURE_SET "\" "                    \
+        XML_ATTR_GENERATION_ADMIN "=\"0\" " XML_ATTR_GENERATION "=\"1\" "   \
+        XML_ATTR_NUMUPDATES "=\"0\">"                                       \
+      "<" XML_CIB_TAG_CONFIGURATION ">"                                     \
+        "<" XML_CIB_TAG_CRMCONFIG "/>"                                      \
+        "<" XML_CIB_TAG_NODES "/>"                                          \
+        "<" XML_CIB_TAG_RESOURCES "/>"                                      \
+        "<" XML_CIB_TAG_CONSTRAINTS "/>"                                    \
+      "</" XML_CIB_TAG_CONFIGURATION ">"                                    \
+      "<" XML_CIB_TAG_STATUS ">"                                            \
+        "<" XML_CIB_TAG_STATE " " XML_ATTR_ID "=\"1\"/>"                    \
+        "<" XML_CIB_TAG_STATE " " XML_ATTR_ID "=\"2\"/>"                    \
+      "</" XML_CIB_TAG_STATUS ">"                                           \
+    "</" XML_TAG_CIB ">"
+
+// Add a request to modify a node_state entry in the status section
+static void
+add_modify(xmlNode *transaction, const char *id)
+{
+    xmlNode *request = create_xml_node(transaction, "cib_command");
+    xmlNode *data = create_xml_node(create_xml_node(request, F_CIB_CALLDATA),
+                                    XML_CIB_TAG_STATE);
+
+    crm_xml_add(request, F_CIB_OPERATION, CIB_OP_MODIFY);
+    crm_xml_add(request, F_CIB_SECTION, XML_CIB_TAG_STATUS);
+    crm_xml_add_int(request, F_CIB_CALLOPTS, cib_none);
+    crm_xml_add(data, XML_ATTR_ID, id);
+    crm_xml_add(data, "modified", XML_BOOLEAN_TRUE);
+}
+
+// Perform a transaction as the CIB manager would for the status section
+static int
+perform_transaction(xmlNode *transaction, xmlNode *current_cib,
+                    xmlNode **result_cib)
+{
+    xmlNode *req = create_xml_node(NULL, "cib_command");
+    xmlNode *output = NULL;
+    gboolean config_changed = FALSE;
+    int rc = pcmk_ok;
+
+    crm_xml_add(req, F_CIB_OPERATION, CIB_OP_TRANSACTION);
+    crm_xml_add(req, F_CIB_SECTION, XML_CIB_TAG_STATUS);
+    rc = cib_perform_op(CIB_OP_TRANSACTION, cib_zero_copy,
+                        cib_process_transaction, FALSE, XML_CIB_TAG_STATUS,
+                        req, transaction, TRUE, &config_changed, current_cib,
+                        result_cib, NULL, &output);
+    free_xml(output);
+    free_xml(req);
+    return rc;
+}
+
+static void
+partial_failure_leaves_cib_unchanged(void **state)
+{
+    xmlNode *cib = string2xml(CIB_XML);
+    xmlNode *transaction = create_xml_node(NULL, XML_TAG_CIB_TRANSACTION);
+    xmlNode *result_cib = NULL;
+    char *before = dump_xml_unformatted(cib);
+    char *after = NULL;
+
+    // The first two requests succeed, then the third finds no such node
+    add_modify(transaction, "1");
+    add_modify(transaction, "2");
+    add_modify(transaction, "3");
+
+    assert_int_equal(perform_transaction(transaction, cib, &result_cib),
+                     -ENXIO);
+    assert_true(result_cib != cib);
+
+    after = dump_xml_unformatted(cib);
+    assert_string_equal(before, after);
+
+    free(after);
+    free(before);
+    free_xml(result_cib);
+    free_xml(transaction);
+    free_xml(cib);
+}
+
+static void
+success_applies_all_requests(void **state)
+{
+    xmlNode *cib = string2xml(CIB_XML);
+    xmlNode *transaction = create_xml_node(NULL, XML_TAG_CIB_TRANSACTION);
+    xmlNode *result_cib = NULL;
+    char *before = dump_xml_unformatted(cib);
+    char *after = NULL;
+    xmlNode *node_state = NULL;
+
+    add_modify(transaction, "1");
+    add_modify(transaction, "2");
+
+    assert_int_equal(perform_transaction(transaction, cib, &result_cib),
+                     pcmk_ok);
+    assert_non_null(result_cib);
+    assert_true(result_cib != cib);
+
+    node_state = pcmk_find_cib_element(result_cib, XML_CIB_TAG_STATUS);
+    for (node_state = first_named_child(node_state, XML_CIB_TAG_STATE);
+         node_state != NULL; node_state = crm_next_same_xml(node_state)) {
+        assert_string_equal(crm_element_value(node_state, "modified"),
+                            XML_BOOLEAN_TRUE);
+    }
+
+    // The caller replaces the current CIB with the result only on success
+    after = dump_xml_unformatted(cib);
+    assert_string_equal(before, after);
+
+    free(after);
+    free(before);
+    free_xml(result_cib);
+    free_xml(transaction);
+    free_xml(cib);
+}
+
+int
+main(int argc, char **argv)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(partial_failure_leaves_cib_unchanged),
+        cmocka_unit_test(success_applies_all_requests),
+    };
+
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -504,7 +504,7 @@ pcmk_message_common_cs(cpg_handle_t handle, uint32_t nodeid, uint32_t pid, void
 
         crm_trace("Decompressing message data");
         uncompressed = calloc(1, new_size);
-        rc = BZ2_bzBuffToBuffDecompress(uncompressed, &new_size, msg->data, msg->compressed_size, 1, 0);
+        rc = BZ2_bzBuffToBuffDecompress(uncompressed, &new_size, msg->data, msg->compressed_size, 0, 0);
 
         if (rc != BZ_OK) {
             crm_err("Decompression failed: %s " CRM_XS " bzerror=%d",
@@ -998,10 +998,9 @@ send_cluster_text(enum crm_ais_msg_class msg_class, const char *data,
     } else {
         char *compressed = NULL;
         unsigned int new_size = 0;
-        char *uncompressed = strdup(data);
 
-        if (pcmk__compress(uncompressed, (unsigned int) msg->size, 0,
-                           &compressed, &new_size) == pcmk_rc_ok) {
+        if (pcmk__compress(data, (unsigned int) msg->size, 0, &compressed,
+                           &new_size) == pcmk_rc_ok) {
 
             msg->header.size = sizeof(pcmk__cpg_msg_t) + new_size;
             msg = pcmk__realloc(msg, msg->header.size);
@@ -1017,7 +1016,6 @@ send_cluster_text(enum crm_ais_msg_class msg_class, const char *data,
             memcpy(msg->data, data, msg->size);
         }
 
-        free(uncompressed);
         free(compressed);
     }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2011-2021 the Pacemaker project contributors
+ * Copyright 2011-2022 the Pacemaker project contributors
  *
  * The version control history for this file may have further details.
  *
@@ -17,6 +17,7 @@
 
 #include <crm/crm.h>
 #include <crm/msg_xml.h>
+#include <crm/common/nvpair.h>
 #include <crm/common/attrd_internal.h>
 
 /*!
@@ -104,6 +105,42 @@ send_attrd_op(crm_ipc_t *ipc, xmlNode *attrd_op)
     return pcmk_legacy2rc(rc);
 }
 
+/*!
+ * \internal
+ * \brief Add the options common to all updates to a pacemaker-attrd request
+ *
+ * \param[in,out] update   Request XML to add options to
+ * \param[in]     value    Attribute value to set
+ * \param[in]     section  Status or nodes
+ * \param[in]     set      ID of attribute set to use (or NULL to choose first)
+ * \param[in]     dampen   Attribute dampening to use
+ * \param[in]     host     Affect only this host (or NULL for all hosts)
+ * \param[in]     options  Bitmask of pcmk__node_attr_opts
+ */
+static void
+add_update_options(xmlNode *update, const char *value, const char *section,
+                   const char *set, const char *dampen, const char *host,
+                   int options)
+{
+    /* remap common aliases */
+    if (pcmk__str_eq(section, "reboot", pcmk__str_casei)) {
+        section = XML_CIB_TAG_STATUS;
+
+    } else if (pcmk__str_eq(section, "forever", pcmk__str_casei)) {
+        section = XML_CIB_TAG_NODES;
+    }
+
+    crm_xml_add(update, PCMK__XA_ATTR_VALUE, value);
+    crm_xml_add(update, PCMK__XA_ATTR_DAMPENING, dampen);
+    crm_xml_add(update, PCMK__XA_ATTR_SECTION, section);
+    crm_xml_add(update, PCMK__XA_ATTR_NODE_NAME, host);
+    crm_xml_add(update, PCMK__XA_ATTR_SET, set);
+    crm_xml_add_int(update, PCMK__XA_ATTR_IS_REMOTE,
+                    pcmk_is_set(options, pcmk__node_attr_remote));
+    crm_xml_add_int(update, PCMK__XA_ATTR_IS_PRIVATE,
+                    pcmk_is_set(options, pcmk__node_attr_private));
+}
+
 /*!
  * \internal
  * \brief Send a request to pacemaker-attrd
@@ -142,14 +179,6 @@ pcmk__node_attr_request(crm_ipc_t *ipc, char command, const char *host,
     const char *display_command = NULL; /* for commands without name/value */
     xmlNode *update = create_attrd_op(user_name);
 
-    /* remap common aliases */
-    if (pcmk__str_eq(section, "reboot", pcmk__str_casei)) {
-        section = XML_CIB_TAG_STATUS;
-
-    } else if (pcmk__str_eq(section, "forever", pcmk__str_casei)) {
-        section = XML_CIB_TAG_NODES;
-    }
-
     if (name == NULL && command == 'U') {
         command = 'R';
     }
@@ -196,15 +225,7 @@ pcmk__node_attr_request(crm_ipc_t *ipc, char command, const char *host,
     }
 
     crm_xml_add(update, PCMK__XA_TASK, task);
-    crm_xml_add(update, PCMK__XA_ATTR_VALUE, value);
-    crm_xml_add(update, PCMK__XA_ATTR_DAMPENING, dampen);
-    crm_xml_add(update, PCMK__XA_ATTR_SECTION, section);
-    crm_xml_add(update, PCMK__XA_ATTR_NODE_NAME, host);
-    crm_xml_add(update, PCMK__XA_ATTR_SET, set);
-    crm_xml_add_int(update, PCMK__XA_ATTR_IS_REMOTE,
-                    pcmk_is_set(options, pcmk__node_attr_remote));
-    crm_xml_add_int(update, PCMK__XA_ATTR_IS_PRIVATE,
-                    pcmk_is_set(options, pcmk__node_attr_private));
+    add_update_options(update, value, section, set, dampen, host, options);
 
     rc = send_attrd_op(ipc, update);
 
@@ -221,6 +242,70 @@ done:
     return rc;
 }
 
+/*!
+ * \internal
+ * \brief Send a single request to pacemaker-attrd to update many attributes
+ *
+ * \param[in] ipc        Connection to pacemaker-attrd (or NULL to use a local
+ *                       connection)
+ * \param[in] host       Affect only this host (or NULL for all hosts)
+ * \param[in] attrs      List of pcmk_nvpair_t with attribute names and values
+ *                       to set (a NULL value deletes the attribute)
+ * \param[in] section    Status or nodes
+ * \param[in] set        ID of attribute set to use (or NULL to choose first)
+ * \param[in] dampen     Attribute dampening to use if creating attributes
+ * \param[in] user_name  ACL user to pass to pacemaker-attrd
+ * \param[in] options    Bitmask of pcmk__node_attr_opts
+ *
+ * \return Standard Pacemaker return code
+ * \note pacemaker-attrd applies all of the updates, and passes them to its
+ *       peers, as a single message. This is equivalent to (but much more
+ *       efficient than) calling pcmk__node_attr_request() with command 'U' for
+ *       each entry in \p attrs.
+ */
+int
+pcmk__node_attr_update_list(crm_ipc_t *ipc, const char *host, GSList *attrs,
+                            const char *section, const char *set,
+                            const char *dampen, const char *user_name,
+                            int options)
+{
+    int rc = pcmk_rc_ok;
+    int n_attrs = 0;
+    xmlNode *update = NULL;
+
+    if (attrs == NULL) {
+        return pcmk_rc_ok;
+    }
+
+    update = create_attrd_op(user_name);
+    crm_xml_add(update, PCMK__XA_TASK, PCMK__ATTRD_CMD_UPDATE);
+
+    for (GSList *iter = attrs; iter != NULL; iter = iter->next) {
+        pcmk_nvpair_t *pair = iter->data;
+        xmlNode *child = NULL;
+
+        if (pair->name == NULL) {
+            rc = EINVAL;
+            goto done;
+        }
+        child = create_xml_node(update, __func__);
+        crm_xml_add(child, PCMK__XA_TASK, PCMK__ATTRD_CMD_UPDATE);
+        crm_xml_add(child, PCMK__XA_ATTR_NAME, pair->name);
+        add_update_options(child, pair->value, section, set, dampen, host,
+                           options);
+        n_attrs++;
+    }
+
+    rc = send_attrd_op(ipc, update);
+
+done:
+    free_xml(update);
+    crm_debug("Asked pacemaker-attrd to update %d attribute%s for %s: %s (%d)",
+              n_attrs, pcmk__plural_s(n_attrs), (host? host : "localhost"),
+              pcmk_rc_str(rc), rc);
+    return rc;
+}
+
 /*!
  * \internal
  * \brief Send a request to pacemaker-attrd to clear resource failure
@@ -121,6 +121,13 @@ pcmk__xml_attr_value(const xmlAttr *attr)
 
 #define PCMK__IPC_VERSION 1
 
+/* Each part of a multipart message uses this header version, so that older
+ * peers reject it rather than mistake a partial payload for a whole message.
+ * Parts are never compressed, so their size_compressed instead holds the offset
+ * of the part's data within the whole message.
+ */
+#define PCMK__IPC_MULTIPART_VERSION 2
+
 #define PCMK__CONTROLD_API_MAJOR "1"
 #define PCMK__CONTROLD_API_MINOR "0"
 
@@ -227,6 +234,10 @@ unsigned int pcmk__ipc_buffer_size(unsigned int max);
 G_GNUC_INTERNAL
 bool pcmk__valid_ipc_header(const pcmk__ipc_header_t *header);
 
+G_GNUC_INTERNAL
+int pcmk__ipc_add_part(const pcmk__ipc_header_t *header, char **message,
+                       unsigned int *received);
+
 G_GNUC_INTERNAL
 pcmk__ipc_methods_t *pcmk__controld_api_methods(void);
 
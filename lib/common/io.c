@@ -562,6 +562,13 @@ pcmk__close_fds_in_child(bool all)
     rlim_t max_fd;
     int min_fd = (all? 0 : (STDERR_FILENO + 1));
 
+#ifdef HAVE_CLOSE_RANGE
+    // This can fail if the kernel is older than the C library
+    if (close_range(min_fd, ~0U, 0) == 0) {
+        return;
+    }
+#endif
+
     /* Find the current process's (soft) limit for open files. getrlimit()
      * should always work, but have a fallback just in case.
      */
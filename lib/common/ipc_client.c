@@ -571,6 +571,38 @@ pcmk_register_ipc_callback(pcmk_ipc_api_t *api, pcmk_ipc_callback_t cb,
     api->user_data = user_data;
 }
 
+/*!
+ * \internal
+ * \brief Wait for the next part of a multipart message on an IPC connection
+ *
+ * \param[in] ipc         IPC connection to wait on
+ * \param[in] timeout_ms  Give up after this many milliseconds
+ *
+ * \return Standard Pacemaker return code (ETIME if nothing arrived in time)
+ */
+static int
+wait_for_next_part(crm_ipc_t *ipc, int timeout_ms)
+{
+    struct pollfd pollfd = { 0, };
+    int rc = crm_ipc_ready(ipc);
+
+    if (rc < 0) {
+        return -rc; // Most likely, the connection was closed
+    } else if (rc > 0) {
+        return pcmk_rc_ok;
+    }
+
+    pollfd.fd = crm_ipc_get_fd(ipc);
+    pollfd.events = POLLIN;
+    rc = poll(&pollfd, 1, timeout_ms);
+    if (rc < 0) {
+        return errno;
+    } else if (rc == 0) {
+        return ETIME;
+    }
+    return crm_ipc_connected(ipc)? pcmk_rc_ok : ENOTCONN;
+}
+
 /*!
  * \internal
  * \brief Send an XML request across an IPC API connection
@@ -623,6 +655,15 @@ pcmk__send_ipc_request(pcmk_ipc_api_t *api, xmlNode *request)
 
             if (rc == -ENOMSG || rc == pcmk_ok) {
                 return pcmk_rc_ok;
+            } else if (rc == -EAGAIN) {
+                // Only part of a multipart message so far
+                rc = wait_for_next_part(api->ipc, 5000);
+                if (rc != pcmk_rc_ok) {
+                    crm_info("Gave up waiting for rest of %s IPC message: %s",
+                             pcmk_ipc_name(api, true), pcmk_rc_str(rc));
+                    return rc;
+                }
+                continue;
             } else if (rc < 0) {
                 return -rc;
             }
@@ -742,6 +783,11 @@ struct crm_ipc_s {
     char *buffer;
     char *server_name;          // server IPC name being connected to
     qb_ipcc_connection_t *ipc;
+
+    char *event_parts;              // multipart event being reassembled
+    unsigned int event_parts_len;   // bytes of multipart event received
+    char *reply_parts;              // multipart reply being reassembled
+    unsigned int reply_parts_len;   // bytes of multipart reply received
 };
 
 /*!
@@ -908,6 +954,8 @@ crm_ipc_destroy(crm_ipc_t * client)
                       client->server_name);
         }
         free(client->buffer);
+        free(client->event_parts);
+        free(client->reply_parts);
         free(client->server_name);
         free(client);
     }
@@ -992,7 +1040,7 @@ crm_ipc_decompress(crm_ipc_t * client)
                  header->size_compressed, size_u);
 
         rc = BZ2_bzBuffToBuffDecompress(uncompressed + sizeof(pcmk__ipc_header_t), &size_u,
-                                        client->buffer + sizeof(pcmk__ipc_header_t), header->size_compressed, 1, 0);
+                                        client->buffer + sizeof(pcmk__ipc_header_t), header->size_compressed, 0, 0);
 
         if (rc != BZ_OK) {
             crm_err("Decompression failed: %s " CRM_XS " bzerror=%d",
@@ -1023,6 +1071,50 @@ crm_ipc_decompress(crm_ipc_t * client)
     return pcmk_rc_ok;
 }
 
+/*!
+ * \internal
+ * \brief Process a message just read into an IPC client's buffer
+ *
+ * Decompress the message if needed. If it is one part of a multipart message,
+ * add it to the message being reassembled instead, and once that is complete,
+ * make it the client's buffer.
+ *
+ * \param[in,out] client     IPC client whose buffer was just read into
+ * \param[in,out] parts      Multipart message being reassembled (if any)
+ * \param[in,out] parts_len  Bytes of multipart message received so far
+ *
+ * \return Standard Pacemaker return code (EAGAIN if more parts are expected)
+ */
+static int
+crm_ipc_decode(crm_ipc_t *client, char **parts, unsigned int *parts_len)
+{
+    pcmk__ipc_header_t *header = (pcmk__ipc_header_t *)(void*)client->buffer;
+    int rc = pcmk_rc_ok;
+
+    if (!pcmk_is_set(header->flags, crm_ipc_multipart)) {
+        return crm_ipc_decompress(client);
+    }
+
+    rc = pcmk__ipc_add_part(header, parts, parts_len);
+    if (rc != pcmk_rc_ok) {
+        return rc;
+    }
+
+    header = (pcmk__ipc_header_t *)(void*)*parts;
+    free(client->buffer);
+    client->buffer = *parts;
+    client->buf_size = sizeof(pcmk__ipc_header_t) + header->size_uncompressed;
+    *parts = NULL;
+    *parts_len = 0;
+
+    // Never let the buffer fall below the size required for IPC reads
+    if (client->buf_size < client->max_buf_size) {
+        client->buffer = pcmk__realloc(client->buffer, client->max_buf_size);
+        client->buf_size = client->max_buf_size;
+    }
+    return pcmk_rc_ok;
+}
+
 long
 crm_ipc_read(crm_ipc_t * client)
 {
@@ -1036,7 +1128,8 @@ crm_ipc_read(crm_ipc_t * client)
     client->msg_size = qb_ipcc_event_recv(client->ipc, client->buffer,
                                           client->buf_size, 0);
     if (client->msg_size >= 0) {
-        int rc = crm_ipc_decompress(client);
+        int rc = crm_ipc_decode(client, &(client->event_parts),
+                                &(client->event_parts_len));
 
         if (rc != pcmk_rc_ok) {
             return pcmk_rc2legacy(rc);
@@ -1113,8 +1206,14 @@ internal_ipc_get_reply(crm_ipc_t *client, int request_id, int ms_timeout,
         if (*bytes > 0) {
             pcmk__ipc_header_t *hdr = NULL;
 
-            rc = crm_ipc_decompress(client);
-            if (rc != pcmk_rc_ok) {
+            rc = crm_ipc_decode(client, &(client->reply_parts),
+                                &(client->reply_parts_len));
+            if (rc == EAGAIN) {
+                // Wait for the rest of a multipart reply
+                rc = pcmk_rc_ok;
+                *bytes = -ETIMEDOUT;
+                continue;
+            } else if (rc != pcmk_rc_ok) {
                 return rc;
             }
 
@@ -1149,6 +1248,104 @@ internal_ipc_get_reply(crm_ipc_t *client, int request_id, int ms_timeout,
     return rc;
 }
 
+/*!
+ * \internal
+ * \brief Send an I/O vector to an IPC server, retrying while the server is busy
+ *
+ * \param[in] client   Connection to IPC server
+ * \param[in] iov      I/O vector to send
+ * \param[in] timeout  Stop retrying at this time (or retry indefinitely if 0)
+ *
+ * \return Negative errno on error, otherwise number of bytes sent (0 if the
+ *         connection was already closed)
+ */
+static ssize_t
+send_iov_retry(crm_ipc_t *client, struct iovec *iov, time_t timeout)
+{
+    ssize_t qb_rc = 0;
+
+    do {
+        /* @TODO Is this check really needed? Won't qb_ipcc_sendv() return
+         * an error if it's not connected?
+         */
+        if (!crm_ipc_connected(client)) {
+            return 0;
+        }
+
+        qb_rc = qb_ipcc_sendv(client->ipc, iov, 2);
+    } while ((qb_rc == -EAGAIN)
+             && ((timeout == 0) || (time(NULL) < timeout)));
+    return qb_rc;
+}
+
+/*!
+ * \internal
+ * \brief Send an IPC request to a server, in parts if it is too big for one
+ *
+ * \param[in] client   Connection to IPC server
+ * \param[in] iov      I/O vector for whole request
+ * \param[in] timeout  Stop retrying at this time (or retry indefinitely if 0)
+ *
+ * \return Negative errno on error, otherwise number of bytes sent (0 if the
+ *         connection was closed before anything was sent)
+ */
+static ssize_t
+send_request(crm_ipc_t *client, struct iovec *iov, time_t timeout)
+{
+    pcmk__ipc_header_t *header = iov[0].iov_base;
+    struct iovec *part = NULL;
+    uint32_t offset = 0;
+    ssize_t sent = 0;
+
+    if (!pcmk_is_set(header->flags, crm_ipc_multipart)) {
+        return send_iov_retry(client, iov, timeout);
+    }
+
+    crm_trace("Sending %s IPC request %d of %u bytes in parts",
+              client->server_name, header->qb.id, header->size_uncompressed);
+    while ((part = pcmk__ipc_multipart_iov(iov, client->max_buf_size,
+                                           &offset)) != NULL) {
+        ssize_t qb_rc = send_iov_retry(client, part, timeout);
+
+        pcmk_free_ipc_event(part);
+        if (qb_rc == 0) {
+            // Connection closed before or partway through the request
+            return (sent > 0)? -ENOTCONN : 0;
+        } else if (qb_rc < 0) {
+            return qb_rc;
+        }
+        sent += qb_rc;
+    }
+    return sent;
+}
+
+/*!
+ * \internal
+ * \brief Finish reading an IPC reply that may be compressed or in parts
+ *
+ * \param[in] client  Connection to IPC server
+ * \param[in] qb_rc   Result of reading the reply (or its first part)
+ *
+ * \return Negative errno on error, otherwise size of reply received in bytes
+ */
+static ssize_t
+finish_reply(crm_ipc_t *client, ssize_t qb_rc)
+{
+    while (qb_rc > 0) {
+        int rc = crm_ipc_decode(client, &(client->reply_parts),
+                                &(client->reply_parts_len));
+
+        if (rc == pcmk_rc_ok) {
+            break;
+        } else if (rc != EAGAIN) {
+            return pcmk_rc2legacy(rc);
+        }
+        qb_rc = qb_ipcc_recv(client->ipc, client->buffer, client->buf_size,
+                             -1);
+    }
+    return qb_rc;
+}
+
 /*!
  * \brief Send an IPC XML message
  *
@@ -1171,7 +1368,6 @@ crm_ipc_send(crm_ipc_t * client, xmlNode * message, enum crm_ipc_flags flags, in
     ssize_t bytes = 0;
     struct iovec *iov;
     static uint32_t id = 0;
-    static int factor = 8;
     pcmk__ipc_header_t *header;
 
     if (client == NULL) {
@@ -1192,7 +1388,9 @@ crm_ipc_send(crm_ipc_t * client, xmlNode * message, enum crm_ipc_flags flags, in
 
     if (client->need_reply) {
         qb_rc = qb_ipcc_recv(client->ipc, client->buffer, client->buf_size, ms_timeout);
-        if (qb_rc < 0) {
+        if ((qb_rc < 0)
+            || (crm_ipc_decode(client, &(client->reply_parts),
+                               &(client->reply_parts_len)) == EAGAIN)) {
             crm_warn("Sending %s IPC disabled until pending reply received",
                      client->server_name);
             return -EALREADY;
@@ -1214,6 +1412,8 @@ crm_ipc_send(crm_ipc_t * client, xmlNode * message, enum crm_ipc_flags flags, in
     }
 
     header = iov[0].iov_base;
+    pcmk__clear_ipc_flags(flags, client->server_name,
+                          crm_ipc_multipart|crm_ipc_multipart_end);
     pcmk__set_ipc_flags(header->flags, client->server_name, flags);
 
     if (pcmk_is_set(flags, crm_ipc_proxied)) {
@@ -1221,16 +1421,6 @@ crm_ipc_send(crm_ipc_t * client, xmlNode * message, enum crm_ipc_flags flags, in
         pcmk__clear_ipc_flags(flags, "client", crm_ipc_client_response);
     }
 
-    if(header->size_compressed) {
-        if(factor < 10 && (client->max_buf_size / 10) < (bytes / factor)) {
-            crm_notice("Compressed message exceeds %d0%% of configured IPC "
-                       "limit (%u bytes); consider setting PCMK_ipc_buffer to "
-                       "%u or higher",
-                       factor, client->max_buf_size, 2 * client->max_buf_size);
-            factor++;
-        }
-    }
-
     crm_trace("Sending %s IPC request %d of %u bytes using %dms timeout",
               client->server_name, header->qb.id, header->qb.size, ms_timeout);
 
@@ -1238,17 +1428,7 @@ crm_ipc_send(crm_ipc_t * client, xmlNode * message, enum crm_ipc_flags flags, in
 
         time_t timeout = time(NULL) + 1 + (ms_timeout / 1000);
 
-        do {
-            /* @TODO Is this check really needed? Won't qb_ipcc_sendv() return
-             * an error if it's not connected?
-             */
-            if (!crm_ipc_connected(client)) {
-                goto send_cleanup;
-            }
-
-            qb_rc = qb_ipcc_sendv(client->ipc, iov, 2);
-        } while ((qb_rc == -EAGAIN) && (time(NULL) < timeout));
-
+        qb_rc = send_request(client, iov, timeout);
         rc = (int) qb_rc; // Negative of system errno, or bytes sent
         if (qb_rc <= 0) {
             goto send_cleanup;
@@ -1273,10 +1453,20 @@ crm_ipc_send(crm_ipc_t * client, xmlNode * message, enum crm_ipc_flags flags, in
 
     } else {
         // No timeout, and client response needed
-        do {
-            qb_rc = qb_ipcc_sendv_recv(client->ipc, iov, 2, client->buffer,
-                                       client->buf_size, -1);
-        } while ((qb_rc == -EAGAIN) && crm_ipc_connected(client));
+        if (pcmk_is_set(header->flags, crm_ipc_multipart)) {
+            qb_rc = send_request(client, iov, 0);
+            if (qb_rc > 0) {
+                qb_rc = qb_ipcc_recv(client->ipc, client->buffer,
+                                     client->buf_size, -1);
+            }
+        } else {
+            do {
+                qb_rc = qb_ipcc_sendv_recv(client->ipc, iov, 2,
+                                           client->buffer, client->buf_size,
+                                           -1);
+            } while ((qb_rc == -EAGAIN) && crm_ipc_connected(client));
+        }
+        qb_rc = finish_reply(client, qb_rc);
         rc = (int) qb_rc; // Negative system errno, or size of reply received
     }
 
@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 #include <stdint.h>         // uint64_t
+#include <stdlib.h>         // calloc(), free()
+#include <string.h>         // memcpy()
 #include <sys/types.h>
 
 #include <crm/msg_xml.h>
@@ -84,14 +86,110 @@ pcmk__valid_ipc_header(const pcmk__ipc_header_t *header)
         crm_err("IPC message without header");
         return false;
 
-    } else if (header->version > PCMK__IPC_VERSION) {
+    } else if (header->version > PCMK__IPC_MULTIPART_VERSION) {
         crm_err("Filtering incompatible v%d IPC message (only versions <= %d supported)",
-                header->version, PCMK__IPC_VERSION);
+                header->version, PCMK__IPC_MULTIPART_VERSION);
         return false;
     }
     return true;
 }
 
+/*!
+ * \internal
+ * \brief Add one part of a multipart IPC message to the message being assembled
+ *
+ * \param[in]     header    Header of received part (followed by its data)
+ * \param[in,out] message   Message assembled so far (header followed by data),
+ *                          or NULL if \p header is for the first part
+ * \param[in,out] received  Number of data bytes in \p message so far
+ *
+ * \return pcmk_rc_ok if \p message is now complete, EAGAIN if more parts are
+ *         expected, otherwise another standard Pacemaker return code (in which
+ *         case \p message is discarded)
+ * \note Once complete, \p message starts with the header of the last part
+ *       (which carries the flags of the whole message), and the caller is
+ *       responsible for freeing it.
+ */
+int
+pcmk__ipc_add_part(const pcmk__ipc_header_t *header, char **message,
+                   unsigned int *received)
+{
+    const char *data = (const char *) header + sizeof(pcmk__ipc_header_t);
+    unsigned int len = 0;
+
+    CRM_ASSERT((header != NULL) && (message != NULL) && (received != NULL));
+
+    if ((header->qb.size < sizeof(pcmk__ipc_header_t))
+        || (header->size_uncompressed == 0)) {
+        goto bad_part;
+    }
+    len = header->qb.size - sizeof(pcmk__ipc_header_t);
+
+    if (*message != NULL) {
+        const pcmk__ipc_header_t *first = (const pcmk__ipc_header_t *)
+                                          (const void *) *message;
+
+        if ((first->qb.id != header->qb.id)
+            || (first->size_uncompressed != header->size_uncompressed)) {
+            /* The sender gave up on the previous message partway through, so
+             * this must be the start of a new one
+             */
+            crm_warn("Discarding incomplete multipart IPC message %d "
+                     CRM_XS " size=%u received=%u",
+                     first->qb.id, first->size_uncompressed, *received);
+            free(*message);
+            *message = NULL;
+        }
+    }
+
+    if (*message == NULL) {
+        *received = 0;
+    }
+
+    // Each part gives its offset, so a lost or out-of-order part is detected
+    if (header->size_compressed != *received) {
+        goto bad_part;
+    }
+
+    if (*message == NULL) {
+        *message = calloc(1, sizeof(pcmk__ipc_header_t)
+                             + header->size_uncompressed);
+        if (*message == NULL) {
+            return ENOMEM;
+        }
+    }
+
+    if (len > (header->size_uncompressed - *received)) {
+        goto bad_part;
+    }
+    memcpy(*message + sizeof(pcmk__ipc_header_t) + *received, data, len);
+    *received += len;
+    memcpy(*message, header, sizeof(pcmk__ipc_header_t));
+    ((pcmk__ipc_header_t *) (void *) *message)->size_compressed = 0;
+
+    if (!pcmk_is_set(header->flags, crm_ipc_multipart_end)) {
+        crm_trace("Received %u of %u bytes of multipart IPC message %d",
+                  *received, header->size_uncompressed, header->qb.id);
+        return EAGAIN;
+    }
+
+    if ((*received == header->size_uncompressed)
+        && ((*message)[sizeof(pcmk__ipc_header_t) + *received - 1] == 0)) {
+        crm_trace("Reassembled %u-byte multipart IPC message %d",
+                  *received, header->qb.id);
+        return pcmk_rc_ok;
+    }
+
+bad_part:
+    crm_err("Discarding malformed multipart IPC message %d "
+            CRM_XS " size=%u received=%u",
+            header->qb.id, header->size_uncompressed, *received);
+    free(*message);
+    *message = NULL;
+    *received = 0;
+    return EBADMSG;
+}
+
 const char *
 pcmk__client_type_str(uint64_t client_type)
 {
@@ -330,9 +330,16 @@ pcmk__free_client(pcmk__client_t *c)
         g_queue_free_full(c->event_queue, free_event);
     }
 
+    if (c->response_queue) {
+        crm_debug("Destroying %d unsent response parts",
+                  g_queue_get_length(c->response_queue));
+        g_queue_free_full(c->response_queue, free_event);
+    }
+
     free(c->id);
     free(c->name);
     free(c->user);
+    free(c->multipart);
     if (c->remote) {
         if (c->remote->auth_timeout) {
             g_source_remove(c->remote->auth_timeout);
@@ -408,6 +415,30 @@ pcmk__client_data2xml(pcmk__client_t *c, void *data, uint32_t *id,
         *flags = header->flags;
     }
 
+    if (pcmk_is_set(header->flags, crm_ipc_multipart)) {
+        int rc = pcmk__ipc_add_part(header, &(c->multipart),
+                                    &(c->multipart_len));
+
+        if (rc != pcmk_rc_ok) {
+            /* Until the last part arrives, there is nothing to process (and
+             * the flags of earlier parts never ask for a response).
+             */
+            return NULL;
+        }
+        header = (pcmk__ipc_header_t *) (void *) c->multipart;
+        text = c->multipart + sizeof(pcmk__ipc_header_t);
+        uncompressed = c->multipart; // Free it when done
+        c->multipart = NULL;
+        c->multipart_len = 0;
+
+        if (flags) {
+            // Framing flags must not be echoed back in any reply
+            *flags = header->flags;
+            pcmk__clear_ipc_flags(*flags, "client",
+                                  crm_ipc_multipart|crm_ipc_multipart_end);
+        }
+    }
+
     if (pcmk_is_set(header->flags, crm_ipc_proxied)) {
         /* Mark this client as being the endpoint of a proxy connection.
          * Proxy connections responses are sent on the event channel, to avoid
@@ -424,7 +455,7 @@ pcmk__client_data2xml(pcmk__client_t *c, void *data, uint32_t *id,
         crm_trace("Decompressing message data %u bytes into %u bytes",
                   header->size_compressed, size_u);
 
-        rc = BZ2_bzBuffToBuffDecompress(uncompressed, &size_u, text, header->size_compressed, 1, 0);
+        rc = BZ2_bzBuffToBuffDecompress(uncompressed, &size_u, text, header->size_compressed, 0, 0);
         text = uncompressed;
 
         if (rc != BZ_OK) {
@@ -469,9 +500,99 @@ delay_next_flush(pcmk__client_t *c, unsigned int queue_len)
     /* Delay a maximum of 1.5 seconds */
     guint delay = (queue_len < 5)? (1000 + 100 * queue_len) : 1500;
 
+    if (c->response_queue != NULL) {
+        /* The client is blocked waiting for the rest of a response, which it
+         * will have room for as soon as it reads the earlier parts
+         */
+        delay = 50;
+    }
+
     c->event_timer = g_timeout_add(delay, crm_ipcs_flush_events_cb, c);
 }
 
+/*!
+ * \internal
+ * \brief Send client any response parts in its queue
+ *
+ * \param[in,out] c  Client to flush
+ *
+ * \return Standard Pacemaker return value
+ * \note Parts that the client does not yet have room for are left queued.
+ */
+static int
+flush_response_parts(pcmk__client_t *c)
+{
+    struct iovec *part = NULL;
+
+    while ((c->response_queue != NULL)
+           && ((part = g_queue_peek_head(c->response_queue)) != NULL)) {
+
+        const pcmk__ipc_header_t *header = part[0].iov_base;
+        ssize_t qb_rc = qb_ipcs_response_sendv(c->ipcs, part, 2);
+
+        if (qb_rc == -EAGAIN) {
+            crm_trace("Response %d to %p[%d] delayed with %u parts unsent",
+                      header->qb.id, c->ipcs, c->pid,
+                      g_queue_get_length(c->response_queue));
+            return pcmk_rc_ok;
+
+        } else if (qb_rc < header->qb.size) {
+            int rc = (qb_rc < 0)? (int) -qb_rc : EIO;
+
+            crm_notice("Response %d to pid %d failed with %u parts unsent: %s "
+                       CRM_XS " rc=%lld ipcs=%p",
+                       header->qb.id, c->pid,
+                       g_queue_get_length(c->response_queue),
+                       pcmk_rc_str(rc), (long long) qb_rc, c->ipcs);
+            g_queue_free_full(c->response_queue, free_event);
+            c->response_queue = NULL;
+            return rc;
+        }
+
+        pcmk_free_ipc_event(g_queue_pop_head(c->response_queue));
+        if (g_queue_is_empty(c->response_queue)) {
+            crm_trace("Response %d to %p[%d] completed",
+                      header->qb.id, c->ipcs, c->pid);
+            g_queue_free(c->response_queue);
+            c->response_queue = NULL;
+        }
+    }
+    return pcmk_rc_ok;
+}
+
+/*!
+ * \internal
+ * \brief Send the next part of a client's first queued multipart event
+ *
+ * \param[in,out] c      Client to send part to
+ * \param[in]     event  I/O vector for whole event
+ *
+ * \return Standard Pacemaker return code
+ * \note The whole event is queued as a single entry, so that the backlog and
+ *       eviction logic count messages rather than parts. c->event_offset
+ *       tracks how much of it has been sent.
+ */
+static int
+send_event_part(pcmk__client_t *c, const struct iovec *event)
+{
+    uint32_t offset = c->event_offset;
+    struct iovec *part = pcmk__ipc_multipart_iov(event, 0, &offset);
+    ssize_t qb_rc = 0;
+
+    CRM_CHECK(part != NULL, return EINVAL);
+    qb_rc = qb_ipcs_event_sendv(c->ipcs, part, 2);
+    pcmk_free_ipc_event(part);
+    if (qb_rc < 0) {
+        return (int) -qb_rc; // Try the same part again next time
+    }
+
+    crm_trace("Event %d to %p[%d] (%lld bytes at offset %u) sent",
+              ((const pcmk__ipc_header_t *) event[0].iov_base)->qb.id,
+              c->ipcs, c->pid, (long long) qb_rc, c->event_offset);
+    c->event_offset = offset;
+    return pcmk_rc_ok;
+}
+
 /*!
  * \internal
  * \brief Send client any messages in its queue
@@ -497,6 +618,8 @@ crm_ipcs_flush_events(pcmk__client_t *c)
         return rc;
     }
 
+    flush_response_parts(c);
+
     if (c->event_queue) {
         queue_len = g_queue_get_length(c->event_queue);
     }
@@ -512,16 +635,32 @@ crm_ipcs_flush_events(pcmk__client_t *c)
             break;
         }
 
-        qb_rc = qb_ipcs_event_sendv(c->ipcs, event, 2);
-        if (qb_rc < 0) {
-            rc = (int) -qb_rc;
-            break;
+        header = event[0].iov_base;
+        if (pcmk_is_set(header->flags, crm_ipc_multipart)) {
+            rc = send_event_part(c, event);
+            if (rc != pcmk_rc_ok) {
+                break;
+            }
+            if (c->event_offset < header->size_uncompressed) {
+                continue; // Keep going until the client is full
+            }
+            c->event_offset = 0;
+
+        } else {
+            qb_rc = qb_ipcs_event_sendv(c->ipcs, event, 2);
+            if (qb_rc < 0) {
+                rc = (int) -qb_rc;
+                break;
+            }
         }
         event = g_queue_pop_head(c->event_queue);
 
         sent++;
-        header = event[0].iov_base;
-        if (header->size_compressed) {
+        if (pcmk_is_set(header->flags, crm_ipc_multipart)) {
+            crm_trace("Event %d to %p[%d] (%u bytes in parts) sent",
+                      header->qb.id, c->ipcs, c->pid,
+                      header->size_uncompressed);
+        } else if (header->size_compressed) {
             crm_trace("Event %d to %p[%d] (%lld compressed bytes) sent",
                       header->qb.id, c->ipcs, c->pid, (long long) qb_rc);
         } else {
@@ -565,11 +704,20 @@ crm_ipcs_flush_events(pcmk__client_t *c)
     } else {
         /* Event queue is empty, there is no backlog */
         c->queue_backlog = 0;
+
+        if (c->response_queue != NULL) {
+            delay_next_flush(c, 0);
+        }
     }
 
     return rc;
 }
 
+/* bzip2 rarely shrinks our XML by more than this factor, so a message bigger
+ * than this many times the IPC buffer size won't fit even when compressed
+ */
+#define IPC_MAX_COMPRESSION_RATIO 20
+
 /*!
  * \internal
  * \brief Create an I/O vector for sending an IPC XML message
@@ -581,16 +729,19 @@ crm_ipcs_flush_events(pcmk__client_t *c)
  * \param[out] bytes          Size of prepared data in bytes
  *
  * \return Standard Pacemaker return code
+ * \note If the message does not fit in \p max_send_size, it is compressed
+ *       (unless it is clearly too big to fit even then). If it still does not
+ *       fit, the result is flagged as multipart, and the
+ *       sender must split it with pcmk__ipc_multipart_iov() rather than
+ *       sending it directly.
  */
 int
 pcmk__ipc_prepare_iov(uint32_t request, xmlNode *message,
                       uint32_t max_send_size, struct iovec **result,
                       ssize_t *bytes)
 {
-    static unsigned int biggest = 0;
     struct iovec *iov;
     unsigned int total = 0;
-    char *compressed = NULL;
     char *buffer = NULL;
     pcmk__ipc_header_t *header = NULL;
 
@@ -619,16 +770,26 @@ pcmk__ipc_prepare_iov(uint32_t request, xmlNode *message,
     header->size_uncompressed = 1 + strlen(buffer);
     total = iov[0].iov_len + header->size_uncompressed;
 
-    if (total < max_send_size) {
-        iov[1].iov_base = buffer;
-        iov[1].iov_len = header->size_uncompressed;
+    iov[1].iov_base = buffer;
+    iov[1].iov_len = header->size_uncompressed;
 
-    } else {
+    if (total >= max_send_size) {
+        char *compressed = NULL;
         unsigned int new_size = 0;
 
-        if (pcmk__compress(buffer, (unsigned int) header->size_uncompressed,
-                           (unsigned int) max_send_size, &compressed,
-                           &new_size) == pcmk_rc_ok) {
+        /* Compression is understood by peers of any version, so try it first.
+         * Only if the message still doesn't fit, send it uncompressed as a
+         * series of parts that each fit in the IPC buffer (which peers older
+         * than PCMK__IPC_MULTIPART_VERSION will reject). Don't bother
+         * compressing a message too big to fit even at the best ratio we can
+         * expect, since that would be all cost and no benefit.
+         */
+        if ((header->size_uncompressed
+             <= (max_send_size * IPC_MAX_COMPRESSION_RATIO))
+            && (pcmk__compress(buffer,
+                               (unsigned int) header->size_uncompressed, 0,
+                               &compressed, &new_size) == pcmk_rc_ok)
+            && ((iov[0].iov_len + new_size) < max_send_size)) {
 
             pcmk__set_ipc_flags(header->flags, "send data", crm_ipc_compressed);
             header->size_compressed = new_size;
@@ -638,21 +799,12 @@ pcmk__ipc_prepare_iov(uint32_t request, xmlNode *message,
 
             free(buffer);
 
-            biggest = QB_MAX(header->size_compressed, biggest);
-
         } else {
-            crm_log_xml_trace(message, "EMSGSIZE");
-            biggest = QB_MAX(header->size_uncompressed, biggest);
-
-            crm_err("Could not compress %u-byte message into less than IPC "
-                    "limit of %u bytes; set PCMK_ipc_buffer to higher value "
-                    "(%u bytes suggested)",
-                    header->size_uncompressed, max_send_size, 4 * biggest);
-
             free(compressed);
-            free(buffer);
-            pcmk_free_ipc_event(iov);
-            return EMSGSIZE;
+            pcmk__set_ipc_flags(header->flags, "send data", crm_ipc_multipart);
+            crm_trace("Sending %u-byte message in parts (IPC limit is %u "
+                      "bytes even when compressed)",
+                      header->size_uncompressed, max_send_size);
         }
     }
 
@@ -667,6 +819,131 @@ pcmk__ipc_prepare_iov(uint32_t request, xmlNode *message,
     return pcmk_rc_ok;
 }
 
+/*!
+ * \internal
+ * \brief Create an I/O vector for the next part of a multipart IPC message
+ *
+ * \param[in]     iov            I/O vector for whole message, as created by
+ *                               pcmk__ipc_prepare_iov()
+ * \param[in]     max_send_size  If 0, default IPC buffer size is used
+ * \param[in,out] offset         Offset into message data where part starts
+ *                               (will be updated to where the next part starts)
+ *
+ * \return Newly allocated I/O vector for part, or NULL if there are no more
+ * \note The caller is responsible for freeing the result with
+ *       pcmk_free_ipc_event().
+ */
+struct iovec *
+pcmk__ipc_multipart_iov(const struct iovec *iov, uint32_t max_send_size,
+                        uint32_t *offset)
+{
+    const pcmk__ipc_header_t *header = iov[0].iov_base;
+    pcmk__ipc_header_t *part_header = NULL;
+    struct iovec *part = NULL;
+    uint32_t len = 0;
+
+    if (*offset >= header->size_uncompressed) {
+        return NULL;
+    }
+
+    if (max_send_size == 0) {
+        max_send_size = crm_ipc_default_buffer_size();
+    }
+    CRM_ASSERT(max_send_size > (sizeof(pcmk__ipc_header_t) + 1));
+
+    // Like whole messages, each part must be smaller than the buffer
+    len = QB_MIN(max_send_size - sizeof(pcmk__ipc_header_t) - 1,
+                 header->size_uncompressed - *offset);
+
+    part_header = calloc(1, sizeof(pcmk__ipc_header_t));
+    CRM_ASSERT(part_header != NULL);
+    memcpy(part_header, header, sizeof(pcmk__ipc_header_t));
+    part_header->version = PCMK__IPC_MULTIPART_VERSION;
+    part_header->qb.size = sizeof(pcmk__ipc_header_t) + len;
+    part_header->size_compressed = *offset;
+
+    part = pcmk__new_ipc_event();
+    part[0].iov_base = part_header;
+    part[0].iov_len = sizeof(pcmk__ipc_header_t);
+    part[1].iov_base = malloc(len);
+    CRM_ASSERT(part[1].iov_base != NULL);
+    memcpy(part[1].iov_base, (const char *) iov[1].iov_base + *offset, len);
+    part[1].iov_len = len;
+
+    *offset += len;
+    if (*offset < header->size_uncompressed) {
+        // Recipient must not reply until it has the whole request
+        pcmk__clear_ipc_flags(part_header->flags, "multipart",
+                              crm_ipc_client_response);
+    } else {
+        pcmk__set_ipc_flags(part_header->flags, "multipart",
+                            crm_ipc_multipart_end);
+    }
+    return part;
+}
+
+/*!
+ * \internal
+ * \brief Copy an IPC message's I/O vector
+ *
+ * \param[in] iov  I/O vector to copy
+ *
+ * \return Newly allocated copy of \p iov
+ * \note The caller is responsible for freeing the result with
+ *       pcmk_free_ipc_event().
+ */
+static struct iovec *
+copy_event(const struct iovec *iov)
+{
+    struct iovec *iov_copy = pcmk__new_ipc_event();
+
+    iov_copy[0].iov_len = iov[0].iov_len;
+    iov_copy[0].iov_base = malloc(iov[0].iov_len);
+    memcpy(iov_copy[0].iov_base, iov[0].iov_base, iov[0].iov_len);
+
+    iov_copy[1].iov_len = iov[1].iov_len;
+    iov_copy[1].iov_base = malloc(iov[1].iov_len);
+    memcpy(iov_copy[1].iov_base, iov[1].iov_base, iov[1].iov_len);
+    return iov_copy;
+}
+
+/*!
+ * \internal
+ * \brief Queue an IPC response to a client, to be sent as room allows
+ *
+ * A multipart response usually won't fit in the client's response buffer all
+ * at once, so its parts are queued and sent as the client reads them. Any
+ * response sent while parts are still queued must be queued behind them, so
+ * that the client receives them in order.
+ *
+ * \param[in,out] c    Client to send response to
+ * \param[in]     iov  I/O vector for whole response
+ *
+ * \return Standard Pacemaker return code
+ */
+static int
+queue_response(pcmk__client_t *c, const struct iovec *iov)
+{
+    const pcmk__ipc_header_t *header = iov[0].iov_base;
+
+    if (c->response_queue == NULL) {
+        c->response_queue = g_queue_new();
+    }
+    if (pcmk_is_set(header->flags, crm_ipc_multipart)) {
+        uint32_t offset = 0;
+        struct iovec *part = NULL;
+
+        crm_trace("Sending %u-byte response %d to %p[%d] in parts",
+                  header->size_uncompressed, header->qb.id, c->ipcs, c->pid);
+        while ((part = pcmk__ipc_multipart_iov(iov, 0, &offset)) != NULL) {
+            g_queue_push_tail(c->response_queue, part);
+        }
+    } else {
+        g_queue_push_tail(c->response_queue, copy_event(iov));
+    }
+    return flush_response_parts(c);
+}
+
 int
 pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags)
 {
@@ -686,27 +963,23 @@ pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags)
         }
     }
 
+    // Only pcmk__ipc_prepare_iov() decides whether a message is multipart
+    pcmk__clear_ipc_flags(flags, "server event",
+                          crm_ipc_multipart|crm_ipc_multipart_end);
     pcmk__set_ipc_flags(header->flags, "server event", flags);
     if (flags & crm_ipc_server_event) {
         header->qb.id = id++;   /* We don't really use it, but doesn't hurt to set one */
 
+        /* A multipart event is queued whole, and split into parts as it is
+         * sent (see send_event_part())
+         */
         if (flags & crm_ipc_server_free) {
             crm_trace("Sending the original to %p[%d]", c->ipcs, c->pid);
             add_event(c, iov);
 
         } else {
-            struct iovec *iov_copy = pcmk__new_ipc_event();
-
             crm_trace("Sending a copy to %p[%d]", c->ipcs, c->pid);
-            iov_copy[0].iov_len = iov[0].iov_len;
-            iov_copy[0].iov_base = malloc(iov[0].iov_len);
-            memcpy(iov_copy[0].iov_base, iov[0].iov_base, iov[0].iov_len);
-
-            iov_copy[1].iov_len = iov[1].iov_len;
-            iov_copy[1].iov_base = malloc(iov[1].iov_len);
-            memcpy(iov_copy[1].iov_base, iov[1].iov_base, iov[1].iov_len);
-
-            add_event(c, iov_copy);
+            add_event(c, copy_event(iov));
         }
 
     } else {
@@ -714,8 +987,12 @@ pcmk__ipc_send_iov(pcmk__client_t *c, struct iovec *iov, uint32_t flags)
 
         CRM_LOG_ASSERT(header->qb.id != 0);     /* Replying to a specific request */
 
-        qb_rc = qb_ipcs_response_sendv(c->ipcs, iov, 2);
-        if (qb_rc < header->qb.size) {
+        if (pcmk_is_set(header->flags, crm_ipc_multipart)
+            || (c->response_queue != NULL)) {
+            rc = queue_response(c, iov);
+
+        } else if ((qb_rc = qb_ipcs_response_sendv(c->ipcs, iov, 2))
+                   < header->qb.size) {
             if (qb_rc < 0) {
                 rc = (int) -qb_rc;
             }
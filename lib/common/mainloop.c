@@ -773,7 +773,12 @@ mainloop_gio_callback(GIOChannel * gio, GIOCondition condition, gpointer data)
                     }
                 }
 
-            } while ((rc == G_SOURCE_CONTINUE) && (read_rc > 0) && --max > 0);
+                /* -EAGAIN means only part of a multipart message was read,
+                 * so keep reading the rest
+                 */
+            } while ((rc == G_SOURCE_CONTINUE)
+                     && ((read_rc > 0) || (read_rc == -EAGAIN))
+                     && (--max > 0));
 
         } else {
             crm_trace("New I/O event for %s after I/O condition %d",
@@ -1008,13 +1008,129 @@ first_matching_xml_child(xmlNode *parent, const char *name, const char *id,
     return NULL;
 }
 
+/* When applying a patchset with several changes, the children of each element
+ * searched by ID are indexed, so that finding (for example) each of many
+ * node_state entries doesn't mean scanning the whole status section again.
+ *
+ * The index maps a parent element to a table of its children, keyed by the
+ * path component that selects each child (TAG[@id='ID']). A parent with
+ * duplicate keys maps to NULL, and is searched the usual way.
+ */
+
+static void
+free_children_table(gpointer data)
+{
+    if (data != NULL) {
+        g_hash_table_destroy((GHashTable *) data);
+    }
+}
+
+// Create an index of element children for applying a patchset
+static GHashTable *
+new_child_index(void)
+{
+    return g_hash_table_new_full(NULL, NULL, NULL, free_children_table);
+}
+
+/*!
+ * \internal
+ * \brief Find a child element by path component using a child index
+ *
+ * \param[in,out] index      Child index (parent is indexed if not already)
+ * \param[in]     parent     Element to search children of
+ * \param[in]     component  Path component in the form TAG[@id='ID']
+ * \param[out]    found      Where to store matching child (or NULL)
+ *
+ * \return true if \p parent could be searched using the index, otherwise false
+ */
+static bool
+find_indexed_child(GHashTable *index, xmlNode *parent, const char *component,
+                   xmlNode **found)
+{
+    GHashTable *children = NULL;
+
+    if (!g_hash_table_lookup_extended(index, parent, NULL,
+                                      (gpointer *) &children)) {
+
+        children = pcmk__strkey_table(free, NULL);
+        for (xmlNode *child = pcmk__xml_first_child(parent); child != NULL;
+             child = pcmk__xml_next(child)) {
+
+            const char *id = ID(child);
+            char *key = NULL;
+
+            if ((child->type != XML_ELEMENT_NODE) || (id == NULL)) {
+                continue;
+            }
+            key = crm_strdup_printf("%s[@id='%s']", child->name, id);
+            if (g_hash_table_contains(children, key)) {
+                free(key);
+                g_hash_table_destroy(children);
+                children = NULL;
+                break;
+            }
+            g_hash_table_insert(children, key, child);
+        }
+        g_hash_table_insert(index, parent, children);
+    }
+
+    if (children == NULL) {
+        return false;
+    }
+    *found = g_hash_table_lookup(children, component);
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Forget the child indexes of an element and its descendants
+ *
+ * \param[in,out] index  Child index
+ * \param[in]     xml    Element about to be freed (so its address may be reused)
+ */
+static void
+forget_child_indexes(GHashTable *index, xmlNode *xml)
+{
+    g_hash_table_remove(index, xml);
+    for (xmlNode *child = pcmk__xml_first_child(xml); child != NULL;
+         child = pcmk__xml_next(child)) {
+        forget_child_indexes(index, child);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Remove an element and its descendants from a child index
+ *
+ * \param[in,out] index  Child index
+ * \param[in]     xml    Element about to be freed
+ */
+static void
+unindex_child(GHashTable *index, xmlNode *xml)
+{
+    GHashTable *children = NULL;
+
+    if ((xml->parent != NULL) && (ID(xml) != NULL)
+        && g_hash_table_lookup_extended(index, xml->parent, NULL,
+                                        (gpointer *) &children)
+        && (children != NULL)) {
+
+        char *key = crm_strdup_printf("%s[@id='%s']", xml->name, ID(xml));
+
+        g_hash_table_remove(children, key);
+        free(key);
+    }
+    forget_child_indexes(index, xml);
+}
+
 /*!
  * \internal
  * \brief Simplified, more efficient alternative to get_xpath_object()
  *
- * \param[in] top              Root of XML to search
- * \param[in] key              Search xpath
- * \param[in] target_position  If deleting, where to delete
+ * \param[in]     top              Root of XML to search
+ * \param[in]     key              Search xpath
+ * \param[in]     target_position  If deleting, where to delete
+ * \param[in,out] index            Child index to use (or NULL for none)
  *
  * \return XML child matching xpath if found, NULL otherwise
  *
@@ -1022,7 +1138,8 @@ first_matching_xml_child(xmlNode *parent, const char *name, const char *id,
  *       i.e. the only allowed search predicate is [@id='XXX'].
  */
 static xmlNode *
-search_v2_xpath(xmlNode *top, const char *key, int target_position)
+search_v2_xpath(xmlNode *top, const char *key, int target_position,
+                GHashTable *index)
 {
     xmlNode *target = (xmlNode *) top->doc;
     const char *current = key;
@@ -1074,8 +1191,12 @@ search_v2_xpath(xmlNode *top, const char *key, int target_position)
                                                       current_position);
                     break;
                 case 2:
-                    target = first_matching_xml_child(target, tag, id,
-                                                      current_position);
+                    if ((index == NULL) || (current_position >= 0)
+                        || !find_indexed_child(index, target, section,
+                                               &target)) {
+                        target = first_matching_xml_child(target, tag, id,
+                                                          current_position);
+                    }
                     break;
                 default:
                     // This should not be possible
@@ -1145,6 +1266,13 @@ apply_v2_patchset(xmlNode *xml, xmlNode *patchset)
     xmlNode *change = NULL;
     GList *change_objs = NULL;
     GList *gIter = NULL;
+    GHashTable *index = NULL;
+
+    // Indexing pays off only if there are multiple changes to look up
+    change = first_named_child(patchset, XML_DIFF_CHANGE);
+    if ((change != NULL) && (crm_next_same_xml(change) != NULL)) {
+        index = new_child_index();
+    }
 
     for (change = pcmk__xml_first_child(patchset); change != NULL;
          change = pcmk__xml_next(change)) {
@@ -1163,7 +1291,7 @@ apply_v2_patchset(xmlNode *xml, xmlNode *patchset)
         if (strcmp(op, "delete") == 0) {
             crm_element_value_int(change, XML_DIFF_POSITION, &position);
         }
-        match = search_v2_xpath(xml, xpath, position);
+        match = search_v2_xpath(xml, xpath, position, index);
         crm_trace("Performing %s on %s with %p", op, xpath, match);
 
         if ((match == NULL) && (strcmp(op, "delete") == 0)) {
@@ -1194,6 +1322,9 @@ apply_v2_patchset(xmlNode *xml, xmlNode *patchset)
             }
 
         } else if (strcmp(op, "delete") == 0) {
+            if (index != NULL) {
+                unindex_child(index, match);
+            }
             free_xml(match);
 
         } else if (strcmp(op, "modify") == 0) {
@@ -1205,6 +1336,11 @@ apply_v2_patchset(xmlNode *xml, xmlNode *patchset)
                 rc = ENOMSG;
                 continue;
             }
+            if ((index != NULL) && (match->parent != NULL)
+                && !pcmk__str_eq(ID(match), ID(attrs), pcmk__str_none)) {
+                // The parent's index would be stale, so rebuild it if needed
+                g_hash_table_remove(index, match->parent);
+            }
             pcmk__xe_remove_matching_attrs(match, NULL, NULL); // Remove all
 
             for (xmlAttrPtr pIter = pcmk__xe_first_attr(attrs); pIter != NULL;
@@ -1318,6 +1454,9 @@ apply_v2_patchset(xmlNode *xml, xmlNode *patchset)
     }
 
     g_list_free_full(change_objs, free);
+    if (index != NULL) {
+        g_hash_table_destroy(index);
+    }
     return rc;
 }
 
@@ -1401,6 +1540,174 @@ xml_apply_patchset(xmlNode *xml, xmlNode *patchset, bool check_version)
     return rc;
 }
 
+/*!
+ * \internal
+ * \brief Parse the path of a v2 patchset change into steps
+ *
+ * \param[in,out] change  Change with path set (steps and buffer will be set)
+ *
+ * \return Standard Pacemaker return code
+ * \note The paths in v2 patchsets have the form /TAG[@id='ID']/TAG/..., where
+ *       the ID predicates are optional.
+ */
+static int
+parse_patch_path(pcmk__patch_change_t *change)
+{
+    int max_steps = 0;
+    char *p = NULL;
+
+    for (const char *c = change->path; *c != '\0'; c++) {
+        if (*c == '/') {
+            max_steps++;
+        }
+    }
+    if ((max_steps == 0) || (change->path[0] != '/')) {
+        return pcmk_rc_diff_failed;
+    }
+
+    change->buffer = strdup(change->path);
+    change->steps = calloc(max_steps, sizeof(pcmk__patch_step_t));
+    CRM_ASSERT((change->buffer != NULL) && (change->steps != NULL));
+
+    p = change->buffer;
+    while (*p == '/') {
+        pcmk__patch_step_t *step = &(change->steps[change->n_steps++]);
+
+        *p++ = '\0';
+        step->tag = p;
+        p += strcspn(p, "/[");
+
+        if (*p == '[') {
+            char *end = NULL;
+
+            if (strncmp(p, "[@id='", 6) != 0) {
+                return pcmk_rc_diff_failed;
+            }
+            *p = '\0';
+            step->id = p + 6;
+
+            // An ID may contain slashes, so look for the end of the predicate
+            end = strstr(step->id, "']");
+            if (end == NULL) {
+                return pcmk_rc_diff_failed;
+            }
+            *end = '\0';
+            p = end + 2;
+        }
+        if (*(step->tag) == '\0') {
+            return pcmk_rc_diff_failed;
+        }
+    }
+    return (*p == '\0')? pcmk_rc_ok : pcmk_rc_diff_failed;
+}
+
+/*!
+ * \internal
+ * \brief Parse the changes in a v2 patchset, so they can be classified cheaply
+ *
+ * \param[in]  patchset   Patchset XML (in v2 format)
+ * \param[out] changes    Where to store newly allocated array of changes
+ * \param[out] n_changes  Where to store number of entries in \p changes
+ *
+ * \return Standard Pacemaker return code
+ * \note A change with a path that can't be parsed is still included, with no
+ *       steps. The caller is responsible for freeing the result with
+ *       pcmk__free_patchset_changes(). The result refers to \p patchset, so
+ *       it must not be used after \p patchset is freed.
+ */
+int
+pcmk__patchset_changes(xmlNode *patchset, pcmk__patch_change_t **changes,
+                       int *n_changes)
+{
+    int max_changes = 0;
+    int format = 1;
+
+    CRM_CHECK((patchset != NULL) && (changes != NULL) && (n_changes != NULL),
+              return EINVAL);
+    *changes = NULL;
+    *n_changes = 0;
+
+    crm_element_value_int(patchset, "format", &format);
+    if (format != 2) {
+        return EINVAL;
+    }
+
+    for (xmlNode *change = first_named_child(patchset, XML_DIFF_CHANGE);
+         change != NULL; change = crm_next_same_xml(change)) {
+        max_changes++;
+    }
+    if (max_changes == 0) {
+        return pcmk_rc_ok;
+    }
+    *changes = calloc(max_changes, sizeof(pcmk__patch_change_t));
+    CRM_ASSERT(*changes != NULL);
+
+    for (xmlNode *change = first_named_child(patchset, XML_DIFF_CHANGE);
+         change != NULL; change = crm_next_same_xml(change)) {
+
+        pcmk__patch_change_t *parsed = &((*changes)[*n_changes]);
+
+        parsed->op_name = crm_element_value(change, XML_DIFF_OP);
+        if (parsed->op_name == NULL) {
+            continue;
+        }
+        (*n_changes)++;
+
+        parsed->change = change;
+        parsed->path = crm_element_value(change, XML_DIFF_PATH);
+
+        if (strcmp(parsed->op_name, "create") == 0) {
+            parsed->op = pcmk__patch_op_create;
+            parsed->result = change->children;
+
+        } else if (strcmp(parsed->op_name, "modify") == 0) {
+            parsed->op = pcmk__patch_op_modify;
+            parsed->result = first_named_child(change, XML_DIFF_RESULT);
+            if (parsed->result != NULL) {
+                parsed->result = parsed->result->children;
+            }
+
+        } else if (strcmp(parsed->op_name, "delete") == 0) {
+            parsed->op = pcmk__patch_op_delete;
+
+        } else if (strcmp(parsed->op_name, "move") == 0) {
+            parsed->op = pcmk__patch_op_move;
+
+        } else {
+            parsed->op = pcmk__patch_op_unknown;
+        }
+
+        if ((parsed->path != NULL)
+            && (parse_patch_path(parsed) != pcmk_rc_ok)) {
+            crm_debug("Could not parse patchset change path %s", parsed->path);
+            free(parsed->steps);
+            parsed->steps = NULL;
+            parsed->n_steps = 0;
+        }
+    }
+    return pcmk_rc_ok;
+}
+
+/*!
+ * \internal
+ * \brief Free parsed patchset changes
+ *
+ * \param[in] changes    Changes to free
+ * \param[in] n_changes  Number of entries in \p changes
+ */
+void
+pcmk__free_patchset_changes(pcmk__patch_change_t *changes, int n_changes)
+{
+    if (changes == NULL) {
+        return;
+    }
+    for (int i = 0; i < n_changes; i++) {
+        free(changes[i].steps);
+        free(changes[i].buffer);
+    }
+    free(changes);
+}
+
 void
 purge_diff_markers(xmlNode *a_node)
 {
@@ -557,7 +557,7 @@ pcmk__remote_message_xml(pcmk__remote_t *remote)
 
         rc = BZ2_bzBuffToBuffDecompress(uncompressed + header->payload_offset, &size_u,
                                         remote->buffer + header->payload_offset,
-                                        header->payload_compressed, 1, 0);
+                                        header->payload_compressed, 0, 0);
 
         if (rc != BZ_OK && header->version > REMOTE_MSG_VERSION) {
             crm_warn("Couldn't decompress v%d message, we only understand v%d",
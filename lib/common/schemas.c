@@ -64,6 +64,9 @@ static struct schema_s *known_schemas = NULL;
 static int xml_schema_max = 0;
 static bool silent_logging = FALSE;
 
+// Compiled XSLT stylesheets, indexed by transform name
+static GHashTable *stylesheets = NULL;
+
 static void
 xml_log(int priority, const char *fmt, ...)
 G_GNUC_PRINTF(2, 3);
@@ -465,12 +468,13 @@ validate_with_relaxng(xmlDocPtr doc, gboolean to_logs, const char *relaxng_file,
     relaxng_ctx_cache_t *ctx = NULL;
 
     CRM_CHECK(doc != NULL, return FALSE);
-    CRM_CHECK(relaxng_file != NULL, return FALSE);
 
     if (cached_ctx && *cached_ctx) {
         ctx = *cached_ctx;
 
     } else {
+        CRM_CHECK(relaxng_file != NULL, return FALSE);
+
         crm_debug("Creating RNG parser context");
         ctx = calloc(1, sizeof(relaxng_ctx_cache_t));
 
@@ -497,18 +501,21 @@ validate_with_relaxng(xmlDocPtr doc, gboolean to_logs, const char *relaxng_file,
 
         ctx->valid = xmlRelaxNGNewValidCtxt(ctx->rng);
         CRM_CHECK(ctx->valid != NULL, goto cleanup);
+    }
 
-        if (to_logs) {
-            xmlRelaxNGSetValidErrors(ctx->valid,
-                                     (xmlRelaxNGValidityErrorFunc) xml_log,
-                                     (xmlRelaxNGValidityWarningFunc) xml_log,
-                                     GUINT_TO_POINTER(LOG_ERR));
-        } else {
-            xmlRelaxNGSetValidErrors(ctx->valid,
-                                     (xmlRelaxNGValidityErrorFunc) fprintf,
-                                     (xmlRelaxNGValidityWarningFunc) fprintf,
-                                     stderr);
-        }
+    /* A cached context may have been created for a caller with a different
+     * preference, so (cheaply) set where errors go every time
+     */
+    if (to_logs) {
+        xmlRelaxNGSetValidErrors(ctx->valid,
+                                 (xmlRelaxNGValidityErrorFunc) xml_log,
+                                 (xmlRelaxNGValidityWarningFunc) xml_log,
+                                 GUINT_TO_POINTER(LOG_ERR));
+    } else {
+        xmlRelaxNGSetValidErrors(ctx->valid,
+                                 (xmlRelaxNGValidityErrorFunc) fprintf,
+                                 (xmlRelaxNGValidityWarningFunc) fprintf,
+                                 stderr);
     }
 
     /* xmlRelaxNGSetValidStructuredErrors( */
@@ -584,6 +591,11 @@ crm_schema_cleanup(void)
     free(known_schemas);
     known_schemas = NULL;
 
+    if (stylesheets != NULL) {
+        g_hash_table_destroy(stylesheets);
+        stylesheets = NULL;
+    }
+
     wrap_libxslt(true);
 }
 
@@ -604,11 +616,15 @@ validate_with(xmlNode *xml, int method, gboolean to_logs)
 
     CRM_CHECK(xml != NULL, return FALSE);
     doc = getDocPtr(xml);
-    file = pcmk__xml_artefact_path(pcmk__xml_artefact_ns_legacy_rng,
-                                   known_schemas[method].name);
+
+    // The schema file is needed only if it hasn't been parsed yet
+    if (known_schemas[method].cache == NULL) {
+        file = pcmk__xml_artefact_path(pcmk__xml_artefact_ns_legacy_rng,
+                                       known_schemas[method].name);
+    }
 
     crm_trace("Validating with: %s (type=%d)",
-              crm_str(file), known_schemas[method].validator);
+              known_schemas[method].name, known_schemas[method].validator);
     switch (known_schemas[method].validator) {
         case schema_validator_rng:
             valid =
@@ -894,10 +910,46 @@ cib_upgrade_err(void *ctx, const char *fmt, ...)
 #define PCMK_SCHEMAS_EMERGENCY_XSLT 1
 #endif
 
+/*!
+ * \internal
+ * \brief Get a compiled XSLT stylesheet, parsing it the first time it's needed
+ *
+ * \param[in] transform  Name of transform (without path or .xsl suffix)
+ *
+ * \return Stylesheet (owned by the stylesheet cache), or NULL on error
+ * \note The cache is freed by crm_schema_cleanup().
+ */
+static xsltStylesheet *
+get_stylesheet(const char *transform)
+{
+    char *xform = NULL;
+    xsltStylesheet *xslt = NULL;
+
+    if (stylesheets == NULL) {
+        stylesheets = pcmk__strkey_table(free,
+                                         (GDestroyNotify) xsltFreeStylesheet);
+    } else {
+        xslt = g_hash_table_lookup(stylesheets, transform);
+        if (xslt != NULL) {
+            return xslt;
+        }
+    }
+
+    xform = pcmk__xml_artefact_path(pcmk__xml_artefact_ns_legacy_xslt,
+                                    transform);
+    crm_debug("Parsing XSLT stylesheet %s", xform);
+    xslt = xsltParseStylesheetFile((pcmkXmlStr) xform);
+    free(xform);
+
+    if (xslt != NULL) {
+        g_hash_table_insert(stylesheets, strdup(transform), xslt);
+    }
+    return xslt;
+}
+
 static xmlNode *
 apply_transformation(xmlNode *xml, const char *transform, gboolean to_logs)
 {
-    char *xform = NULL;
     xmlNode *out = NULL;
     xmlDocPtr res = NULL;
     xmlDocPtr doc = NULL;
@@ -910,8 +962,6 @@ apply_transformation(xmlNode *xml, const char *transform, gboolean to_logs)
 
     CRM_CHECK(xml != NULL, return FALSE);
     doc = getDocPtr(xml);
-    xform = pcmk__xml_artefact_path(pcmk__xml_artefact_ns_legacy_xslt,
-                                    transform);
 
     xmlLoadExtDtdDefaultValue = 1;
     xmlSubstituteEntitiesDefault(1);
@@ -923,7 +973,7 @@ apply_transformation(xmlNode *xml, const char *transform, gboolean to_logs)
         xsltSetGenericErrorFunc(&crm_log_level, cib_upgrade_err);
     }
 
-    xslt = xsltParseStylesheetFile((pcmkXmlStr) xform);
+    xslt = get_stylesheet(transform);
     CRM_CHECK(xslt != NULL, goto cleanup);
 
     res = xsltApplyStylesheet(xslt, doc, NULL);
@@ -944,12 +994,6 @@ apply_transformation(xmlNode *xml, const char *transform, gboolean to_logs)
 #endif
 
   cleanup:
-    if (xslt) {
-        xsltFreeStylesheet(xslt);
-    }
-
-    free(xform);
-
     return out;
 }
 
@@ -744,6 +744,9 @@ pcmk__add_separated_word(char **list, size_t *len, const char *word,
  * \param[out] result_len  Where to store actual compressed length of result
  *
  * \return Standard Pacemaker return code
+ * \note This is used for CPG messages over CRM_BZ2_THRESHOLD, and for IPC
+ *       messages too large for the IPC buffer (before resorting to sending
+ *       them in parts).
  */
 int
 pcmk__compress(const char *data, unsigned int length, unsigned int max,
@@ -751,7 +754,6 @@ pcmk__compress(const char *data, unsigned int length, unsigned int max,
 {
     int rc;
     char *compressed = NULL;
-    char *uncompressed = strdup(data);
 #ifdef CLOCK_MONOTONIC
     struct timespec after_t;
     struct timespec before_t;
@@ -768,10 +770,12 @@ pcmk__compress(const char *data, unsigned int length, unsigned int max,
     compressed = calloc((size_t) max, sizeof(char));
     CRM_ASSERT(compressed);
 
+    /* The source argument isn't const, but bzip2 only reads it, so there is
+     * no need to copy what may be a very large buffer
+     */
     *result_len = max;
-    rc = BZ2_bzBuffToBuffCompress(compressed, result_len, uncompressed, length,
-                                  CRM_BZ2_BLOCKS, 0, CRM_BZ2_WORK);
-    free(uncompressed);
+    rc = BZ2_bzBuffToBuffCompress(compressed, result_len, (char *) data,
+                                  length, CRM_BZ2_BLOCKS, 0, CRM_BZ2_WORK);
     if (rc != BZ_OK) {
         crm_err("Compression of %d bytes failed: %s " CRM_XS " bzerror=%d",
                 length, bz2_strerror(rc), rc);
@@ -0,0 +1,249 @@
+/*
+ * Copyright 2022 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU Lesser General Public License
+ * version 2.1 or later (LGPLv2.1+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+#include <crm/common/ipc_internal.h>
+#include "crmcommon_private.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define SMALL_BUFFER 16384
+
+/* Values are pseudo-random, so the message can't be compressed to fit in the
+ * buffer and must be split
+ */
+static xmlNode *
+big_message(void)
+{
+    xmlNode *xml = create_xml_node(NULL, "big");
+    uint32_t seed = 1;
+
+    for (int i = 0; i < 2000; i++) {
+        xmlNode *child = create_xml_node(xml, "child");
+        char value[65] = { '\0', };
+
+        for (int j = 0; j < 64; j += 8) {
+            seed = (seed * 1103515245) + 12345;
+            snprintf(value + j, 9, "%08x", seed);
+        }
+        crm_xml_set_id(child, "child-%d", i);
+        crm_xml_add(child, "value", value);
+    }
+    return xml;
+}
+
+// Split a message into parts as a sender would, returning the number of parts
+static int
+split_message(uint32_t id, xmlNode *xml, struct iovec **iov,
+              struct iovec ***parts)
+{
+    uint32_t offset = 0;
+    int n = 0;
+    struct iovec *part = NULL;
+
+    assert_int_equal(pcmk__ipc_prepare_iov(id, xml, SMALL_BUFFER, iov, NULL),
+                     pcmk_rc_ok);
+    assert_true(pcmk_is_set(((pcmk__ipc_header_t *) (*iov)[0].iov_base)->flags,
+                            crm_ipc_multipart));
+
+    *parts = NULL;
+    while ((part = pcmk__ipc_multipart_iov(*iov, SMALL_BUFFER,
+                                           &offset)) != NULL) {
+        *parts = pcmk__realloc(*parts, (n + 1) * sizeof(struct iovec *));
+        (*parts)[n++] = part;
+    }
+    assert_true(n > 2);
+    return n;
+}
+
+static void
+free_parts(struct iovec *iov, struct iovec **parts, int n)
+{
+    for (int i = 0; i < n; i++) {
+        pcmk_free_ipc_event(parts[i]);
+    }
+    free(parts);
+    pcmk_free_ipc_event(iov);
+}
+
+// Add a part as a receiver would, from a contiguous buffer
+static int
+add_part(struct iovec *part, char **message, unsigned int *received)
+{
+    char *buffer = malloc(part[0].iov_len + part[1].iov_len);
+    int rc;
+
+    assert_non_null(buffer);
+    memcpy(buffer, part[0].iov_base, part[0].iov_len);
+    memcpy(buffer + part[0].iov_len, part[1].iov_base, part[1].iov_len);
+    rc = pcmk__ipc_add_part((const pcmk__ipc_header_t *) (void *) buffer,
+                            message, received);
+    free(buffer);
+    return rc;
+}
+
+static void
+parts_are_reassembled(void **state)
+{
+    xmlNode *xml = big_message();
+    char *text = dump_xml_unformatted(xml);
+    struct iovec *iov = NULL;
+    struct iovec **parts = NULL;
+    char *message = NULL;
+    unsigned int received = 0;
+    pcmk__ipc_header_t *header = NULL;
+    int n = split_message(5, xml, &iov, &parts);
+
+    for (int i = 0; i < (n - 1); i++) {
+        assert_int_equal(add_part(parts[i], &message, &received), EAGAIN);
+        assert_non_null(message);
+    }
+    assert_int_equal(add_part(parts[n - 1], &message, &received), pcmk_rc_ok);
+
+    header = (pcmk__ipc_header_t *) (void *) message;
+    assert_int_equal(received, strlen(text) + 1);
+    assert_int_equal(header->qb.id, 5);
+    assert_int_equal(header->size_uncompressed, received);
+    assert_int_equal(header->size_compressed, 0);
+    assert_true(pcmk_is_set(header->flags, crm_ipc_multipart_end));
+    assert_string_equal(message + sizeof(pcmk__ipc_header_t), text);
+
+    free(message);
+    free_parts(iov, parts, n);
+    free(text);
+    free_xml(xml);
+}
+
+static void
+truncated_message_is_replaced(void **state)
+{
+    xmlNode *xml = big_message();
+    char *text = dump_xml_unformatted(xml);
+    struct iovec *iov1 = NULL;
+    struct iovec *iov2 = NULL;
+    struct iovec **parts1 = NULL;
+    struct iovec **parts2 = NULL;
+    char *message = NULL;
+    unsigned int received = 0;
+    int n1 = split_message(1, xml, &iov1, &parts1);
+    int n2 = split_message(2, xml, &iov2, &parts2);
+
+    // Sender gave up on message 1 partway through, then sent message 2
+    assert_int_equal(add_part(parts1[0], &message, &received), EAGAIN);
+    assert_int_equal(add_part(parts1[1], &message, &received), EAGAIN);
+    for (int i = 0; i < (n2 - 1); i++) {
+        assert_int_equal(add_part(parts2[i], &message, &received), EAGAIN);
+    }
+    assert_int_equal(add_part(parts2[n2 - 1], &message, &received),
+                     pcmk_rc_ok);
+    assert_int_equal(((pcmk__ipc_header_t *) (void *) message)->qb.id, 2);
+    assert_string_equal(message + sizeof(pcmk__ipc_header_t), text);
+
+    free(message);
+    free_parts(iov1, parts1, n1);
+    free_parts(iov2, parts2, n2);
+    free(text);
+    free_xml(xml);
+}
+
+static void
+short_last_part_is_rejected(void **state)
+{
+    xmlNode *xml = big_message();
+    struct iovec *iov = NULL;
+    struct iovec **parts = NULL;
+    char *message = NULL;
+    unsigned int received = 0;
+    int n = split_message(1, xml, &iov, &parts);
+    pcmk__ipc_header_t *last = parts[n - 1][0].iov_base;
+
+    for (int i = 0; i < (n - 1); i++) {
+        assert_int_equal(add_part(parts[i], &message, &received), EAGAIN);
+    }
+
+    // Lose the end of the last part's data
+    parts[n - 1][1].iov_len--;
+    last->qb.size--;
+    assert_int_equal(add_part(parts[n - 1], &message, &received), EBADMSG);
+    assert_null(message);
+    assert_int_equal(received, 0);
+
+    free_parts(iov, parts, n);
+    free_xml(xml);
+}
+
+static void
+missing_part_is_rejected(void **state)
+{
+    xmlNode *xml = big_message();
+    struct iovec *iov = NULL;
+    struct iovec **parts = NULL;
+    char *message = NULL;
+    unsigned int received = 0;
+    int n = split_message(1, xml, &iov, &parts);
+
+    assert_int_equal(add_part(parts[0], &message, &received), EAGAIN);
+    assert_int_equal(add_part(parts[2], &message, &received), EBADMSG);
+    assert_null(message);
+
+    // Nothing after the gap is accepted either
+    for (int i = 3; i < n; i++) {
+        assert_int_equal(add_part(parts[i], &message, &received), EBADMSG);
+        assert_null(message);
+    }
+
+    free_parts(iov, parts, n);
+    free_xml(xml);
+}
+
+static void
+out_of_order_parts_are_rejected(void **state)
+{
+    xmlNode *xml = big_message();
+    struct iovec *iov = NULL;
+    struct iovec **parts = NULL;
+    char *message = NULL;
+    unsigned int received = 0;
+    int n = split_message(1, xml, &iov, &parts);
+
+    // Parts 1 and 2 are the same size, so only their offsets give them away
+    assert_int_equal(parts[1][1].iov_len, parts[2][1].iov_len);
+    assert_int_equal(add_part(parts[0], &message, &received), EAGAIN);
+    assert_int_equal(add_part(parts[2], &message, &received), EBADMSG);
+    assert_null(message);
+
+    // A part other than the first can't start a message
+    assert_int_equal(add_part(parts[1], &message, &received), EBADMSG);
+    assert_null(message);
+
+    free_parts(iov, parts, n);
+    free_xml(xml);
+}
+
+int
+main(int argc, char **argv)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(parts_are_reassembled),
+        cmocka_unit_test(truncated_message_is_replaced),
+        cmocka_unit_test(short_last_part_is_rejected),
+        cmocka_unit_test(missing_part_is_rejected),
+        cmocka_unit_test(out_of_order_parts_are_rejected),
+    };
+
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2022 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU Lesser General Public License
+ * version 2.1 or later (LGPLv2.1+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+#include <crm/common/ipc_internal.h>
+#include "crmcommon_private.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define SMALL_BUFFER 16384
+
+/* Values are pseudo-random, so the message can't be compressed to fit in the
+ * buffer and must be split
+ */
+static xmlNode *
+big_message(void)
+{
+    xmlNode *xml = create_xml_node(NULL, "big");
+    uint32_t seed = 1;
+
+    for (int i = 0; i < 2000; i++) {
+        xmlNode *child = create_xml_node(xml, "child");
+        char value[65] = { '\0', };
+
+        for (int j = 0; j < 64; j += 8) {
+            seed = (seed * 1103515245) + 12345;
+            snprintf(value + j, 9, "%08x", seed);
+        }
+        crm_xml_set_id(child, "child-%d", i);
+        crm_xml_add(child, "value", value);
+    }
+    return xml;
+}
+
+static void
+small_message_is_whole(void **state)
+{
+    xmlNode *xml = create_xml_node(NULL, "small");
+    struct iovec *iov = NULL;
+    pcmk__ipc_header_t *header = NULL;
+
+    assert_int_equal(pcmk__ipc_prepare_iov(1, xml, SMALL_BUFFER, &iov, NULL),
+                     pcmk_rc_ok);
+    header = iov[0].iov_base;
+    assert_false(pcmk_is_set(header->flags, crm_ipc_multipart));
+    assert_int_equal(header->version, PCMK__IPC_VERSION);
+    assert_int_equal(header->size_compressed, 0);
+
+    pcmk_free_ipc_event(iov);
+    free_xml(xml);
+}
+
+static void
+compressible_message_is_compressed(void **state)
+{
+    xmlNode *xml = create_xml_node(NULL, "compressible");
+    struct iovec *iov = NULL;
+    pcmk__ipc_header_t *header = NULL;
+
+    for (int i = 0; i < 1000; i++) {
+        xmlNode *child = create_xml_node(xml, "child");
+
+        crm_xml_set_id(child, "child-with-a-reasonably-long-id-%d", i);
+        crm_xml_add(child, "value", "some data to pad out the message");
+    }
+
+    assert_int_equal(pcmk__ipc_prepare_iov(1, xml, SMALL_BUFFER, &iov, NULL),
+                     pcmk_rc_ok);
+    header = iov[0].iov_base;
+    assert_false(pcmk_is_set(header->flags, crm_ipc_multipart));
+    assert_true(pcmk_is_set(header->flags, crm_ipc_compressed));
+    assert_int_equal(header->version, PCMK__IPC_VERSION);
+    assert_true(header->size_compressed > 0);
+    assert_true(header->qb.size < SMALL_BUFFER);
+
+    pcmk_free_ipc_event(iov);
+    free_xml(xml);
+}
+
+static void
+big_message_is_split(void **state)
+{
+    xmlNode *xml = big_message();
+    char *text = dump_xml_unformatted(xml);
+    char *reassembled = NULL;
+    struct iovec *iov = NULL;
+    struct iovec *part = NULL;
+    pcmk__ipc_header_t *header = NULL;
+    uint32_t offset = 0;
+    int parts = 0;
+
+    assert_int_equal(pcmk__ipc_prepare_iov(1, xml, SMALL_BUFFER, &iov, NULL),
+                     pcmk_rc_ok);
+    header = iov[0].iov_base;
+    assert_true(pcmk_is_set(header->flags, crm_ipc_multipart));
+    assert_int_equal(header->size_compressed, 0);
+    assert_int_equal(header->size_uncompressed, strlen(text) + 1);
+    pcmk__set_ipc_flags(header->flags, "test", crm_ipc_client_response);
+
+    reassembled = calloc(1, header->size_uncompressed);
+    while ((part = pcmk__ipc_multipart_iov(iov, SMALL_BUFFER,
+                                           &offset)) != NULL) {
+        pcmk__ipc_header_t *part_header = part[0].iov_base;
+        bool last = (offset == header->size_uncompressed);
+
+        parts++;
+        assert_true(part_header->qb.size < SMALL_BUFFER);
+        assert_int_equal(part_header->qb.size,
+                         part[0].iov_len + part[1].iov_len);
+        assert_int_equal(part_header->qb.id, header->qb.id);
+        assert_int_equal(part_header->version, PCMK__IPC_MULTIPART_VERSION);
+        assert_int_equal(part_header->size_uncompressed,
+                         header->size_uncompressed);
+        assert_int_equal(part_header->size_compressed,
+                         offset - part[1].iov_len);
+        assert_true(pcmk_is_set(part_header->flags, crm_ipc_multipart));
+        assert_int_equal(pcmk_is_set(part_header->flags, crm_ipc_multipart_end),
+                         last);
+        assert_int_equal(pcmk_is_set(part_header->flags,
+                                     crm_ipc_client_response),
+                         last);
+
+        memcpy(reassembled + offset - part[1].iov_len, part[1].iov_base,
+               part[1].iov_len);
+        pcmk_free_ipc_event(part);
+    }
+
+    assert_true(parts > 1);
+    assert_string_equal(reassembled, text);
+
+    free(reassembled);
+    free(text);
+    pcmk_free_ipc_event(iov);
+    free_xml(xml);
+}
+
+int
+main(int argc, char **argv)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(small_message_is_whole),
+        cmocka_unit_test(compressible_message_is_compressed),
+        cmocka_unit_test(big_message_is_split),
+    };
+
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
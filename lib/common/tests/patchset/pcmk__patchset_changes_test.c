@@ -0,0 +1,125 @@
+/*
+ * Copyright 2022 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU Lesser General Public License
+ * version 2.1 or later (LGPLv2.1+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+#include <crm/msg_xml.h>
+#include <crm/common/xml_internal.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define PATCHSET                                                        \
+    "<diff format='2'>"                                                 \
+      "<version>"                                                       \
+        "<source admin_epoch='0' epoch='1' num_updates='1'/>"           \
+        "<target admin_epoch='0' epoch='1' num_updates='2'/>"           \
+      "</version>"                                                      \
+      "<change operation='modify' path='/cib'>"                         \
+        "<change-list>"                                                 \
+          "<change-attr name='num_updates' operation='set' value='2'/>" \
+        "</change-list>"                                                \
+        "<change-result><cib num_updates='2'/></change-result>"         \
+      "</change>"                                                       \
+      "<change operation='create' path='/cib/status/node_state[@id=&apos;1&apos;]/lrm[@id=&apos;1&apos;]/lrm_resources'>" \
+        "<lrm_resource id='rsc1'/>"                                     \
+      "</change>"                                                       \
+      "<change operation='delete' path='/cib/status/node_state[@id=&apos;1&apos;]/lrm[@id=&apos;1&apos;]/lrm_resources/lrm_resource[@id=&apos;a/b&apos;]'/>" \
+      "<change operation='move' path='/cib/configuration/nodes[bad]'/>" \
+      "<change operation='frobnicate' path='/cib'/>"                    \
+    "</diff>"
+
+static void
+bad_input(void **state) {
+    xmlNode *patchset = string2xml("<diff format='1'/>");
+    pcmk__patch_change_t *changes = NULL;
+    int n_changes = 0;
+
+    assert_int_equal(pcmk__patchset_changes(patchset, &changes, &n_changes),
+                     EINVAL);
+    assert_null(changes);
+    assert_int_equal(n_changes, 0);
+    free_xml(patchset);
+}
+
+static void
+no_changes(void **state) {
+    xmlNode *patchset = string2xml("<diff format='2'/>");
+    pcmk__patch_change_t *changes = NULL;
+    int n_changes = 0;
+
+    assert_int_equal(pcmk__patchset_changes(patchset, &changes, &n_changes),
+                     pcmk_rc_ok);
+    assert_null(changes);
+    assert_int_equal(n_changes, 0);
+    free_xml(patchset);
+}
+
+static void
+parsed(void **state) {
+    xmlNode *patchset = string2xml(PATCHSET);
+    pcmk__patch_change_t *changes = NULL;
+    int n_changes = 0;
+
+    assert_int_equal(pcmk__patchset_changes(patchset, &changes, &n_changes),
+                     pcmk_rc_ok);
+    assert_int_equal(n_changes, 5);
+
+    assert_int_equal(changes[0].op, pcmk__patch_op_modify);
+    assert_int_equal(changes[0].n_steps, 1);
+    assert_string_equal(changes[0].steps[0].tag, XML_TAG_CIB);
+    assert_null(changes[0].steps[0].id);
+    assert_string_equal((const char *) changes[0].result->name, XML_TAG_CIB);
+
+    assert_int_equal(changes[1].op, pcmk__patch_op_create);
+    assert_int_equal(changes[1].n_steps, 5);
+    assert_string_equal(pcmk__patch_change_id(&changes[1], XML_CIB_TAG_STATE),
+                        "1");
+    assert_string_equal(pcmk__patch_change_id(&changes[1], XML_CIB_TAG_LRM),
+                        "1");
+    assert_non_null(pcmk__patch_change_step(&changes[1],
+                                            XML_LRM_TAG_RESOURCES));
+    assert_null(pcmk__patch_change_id(&changes[1], XML_LRM_TAG_RESOURCES));
+    assert_null(pcmk__patch_change_step(&changes[1], XML_LRM_TAG_RSC_OP));
+    assert_string_equal((const char *) changes[1].result->name,
+                        XML_LRM_TAG_RESOURCE);
+
+    assert_int_equal(changes[2].op, pcmk__patch_op_delete);
+    assert_int_equal(changes[2].n_steps, 6);
+    assert_string_equal(pcmk__patch_change_id(&changes[2],
+                                              XML_LRM_TAG_RESOURCE), "a/b");
+    assert_null(changes[2].result);
+
+    assert_int_equal(changes[3].op, pcmk__patch_op_move);
+    assert_int_equal(changes[3].n_steps, 0);
+    assert_null(changes[3].steps);
+
+    assert_int_equal(changes[4].op, pcmk__patch_op_unknown);
+    assert_string_equal(changes[4].op_name, "frobnicate");
+
+    pcmk__free_patchset_changes(changes, n_changes);
+    free_xml(patchset);
+}
+
+int
+main(int argc, char **argv)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(bad_input),
+        cmocka_unit_test(no_changes),
+        cmocka_unit_test(parsed),
+    };
+
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
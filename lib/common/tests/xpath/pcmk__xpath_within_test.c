@@ -0,0 +1,100 @@
+/*
+ * Copyright 2022 the Pacemaker project contributors
+ *
+ * The version control history for this file may have further details.
+ *
+ * This source code is licensed under the GNU Lesser General Public License
+ * version 2.1 or later (LGPLv2.1+) WITHOUT ANY WARRANTY.
+ */
+
+#include <crm_internal.h>
+#include <crm/common/xml_internal.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define NODE1_LRM "/cib/status/node_state[@id='1']/lrm[@id='1']"
+
+static void
+same_path(void **state) {
+    assert_true(pcmk__xpath_within("/cib", "/cib"));
+    assert_true(pcmk__xpath_within("/cib/configuration", "/cib/configuration"));
+    assert_true(pcmk__xpath_within(NODE1_LRM, NODE1_LRM));
+}
+
+static void
+path_below(void **state) {
+    assert_true(pcmk__xpath_within("/cib/configuration/alerts",
+                                   "/cib/configuration"));
+    assert_true(pcmk__xpath_within(NODE1_LRM, "/cib"));
+    assert_true(pcmk__xpath_within(NODE1_LRM "/lrm_resources",
+                                   "/cib/status/node_state[@id='1']"));
+    assert_true(pcmk__xpath_within("/", ""));
+}
+
+static void
+step_without_id(void **state) {
+    assert_true(pcmk__xpath_within(NODE1_LRM, "/cib/status/node_state"));
+    assert_true(pcmk__xpath_within(NODE1_LRM, "/cib/status/node_state/lrm"));
+    assert_true(pcmk__xpath_within("/cib/status/node_state",
+                                   "/cib/status/node_state[@id='1']"));
+    assert_true(pcmk__xpath_within(NODE1_LRM,
+                                   "/cib/status/node_state/lrm[@id='1']"));
+}
+
+static void
+not_within(void **state) {
+    // Ancestor is longer, or is a sibling or differs only by prefix
+    assert_false(pcmk__xpath_within("/cib", "/cib/configuration"));
+    assert_false(pcmk__xpath_within("/cib/status", "/cib/configuration"));
+    assert_false(pcmk__xpath_within("/cib/configurations",
+                                    "/cib/configuration"));
+    assert_false(pcmk__xpath_within("/cib/configuration",
+                                    "/cib/configurations"));
+
+    // Different IDs don't match
+    assert_false(pcmk__xpath_within(NODE1_LRM,
+                                    "/cib/status/node_state[@id='2']"));
+    assert_false(pcmk__xpath_within("/cib/status/node_state[@id='10']",
+                                    "/cib/status/node_state[@id='1']"));
+    assert_false(pcmk__xpath_within(NODE1_LRM, "/cib/status/node_state/lrm"
+                                               "[@id='2']"));
+
+    // A step without an ID still needs the same element name
+    assert_false(pcmk__xpath_within(NODE1_LRM,
+                                    "/cib/status/node_state/transient"));
+    assert_false(pcmk__xpath_within(NODE1_LRM, "/cib/status/node"));
+}
+
+static void
+slash_in_predicate(void **state) {
+    assert_true(pcmk__xpath_within("/cib/x[@id='a/b']/y", "/cib/x[@id='a/b']"));
+    assert_false(pcmk__xpath_within("/cib/x[@id='a/b']/y", "/cib/x[@id='a']"));
+}
+
+static void
+relative_path(void **state) {
+    assert_false(pcmk__xpath_within("/cib/status", "cib"));
+    assert_false(pcmk__xpath_within("cib/status", "/cib"));
+}
+
+int
+main(int argc, char **argv)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(same_path),
+        cmocka_unit_test(path_below),
+        cmocka_unit_test(step_without_id),
+        cmocka_unit_test(not_within),
+        cmocka_unit_test(slash_in_predicate),
+        cmocka_unit_test(relative_path),
+    };
+
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -62,26 +62,50 @@ pcmk__tracking_xml_changes(xmlNode *xml, bool lazy)
     return TRUE;
 }
 
-#define buffer_print(buffer, max, offset, fmt, args...) do {            \
-        int rc = (max);                                                 \
-        if(buffer) {                                                    \
-            rc = snprintf((buffer) + (offset), (max) - (offset), fmt, ##args); \
-        }                                                               \
-        if(buffer && rc < 0) {                                          \
-            crm_perror(LOG_ERR, "snprintf failed at offset %d", offset); \
-            (buffer)[(offset)] = 0;                                     \
-            break;                                                      \
-        } else if(rc >= ((max) - (offset))) {                           \
-            char *tmp = NULL;                                           \
-            (max) = QB_MAX(CHUNK_SIZE, (max) * 2);                      \
-            tmp = pcmk__realloc((buffer), (max));                       \
-            CRM_ASSERT(tmp);                                            \
-            (buffer) = tmp;                                             \
-        } else {                                                        \
-            offset += rc;                                               \
-            break;                                                      \
-        }                                                               \
-    } while(1);
+/*!
+ * \internal
+ * \brief Make sure a dynamically allocated text buffer has room for more text
+ *
+ * \param[in,out] buffer  Buffer to store text in (may be reallocated)
+ * \param[in]     offset  Current position of null terminator within \p buffer
+ * \param[in,out] max     Current size of \p buffer in bytes
+ * \param[in]     len     Number of characters to make room for
+ */
+static inline void
+buffer_reserve(char **buffer, int offset, int *max, size_t len)
+{
+    size_t needed = offset + len + 1;
+
+    if ((*buffer == NULL) || (needed > (size_t) *max)) {
+        size_t new_max = QB_MAX(CHUNK_SIZE, (*max) * 2);
+
+        while (new_max < needed) {
+            new_max *= 2;
+        }
+        *buffer = pcmk__realloc(*buffer, new_max);
+        *max = (int) new_max;
+    }
+}
+
+// Add a given number of characters to a dynamically allocated text buffer
+static inline void
+buffer_add_len(char **buffer, int *offset, int *max, const char *text,
+               size_t len)
+{
+    buffer_reserve(buffer, *offset, max, len);
+    memcpy(*buffer + *offset, text, len);
+    *offset += len;
+    (*buffer)[*offset] = '\0';
+}
+
+// Add a string (if not NULL) to a dynamically allocated text buffer
+static inline void
+buffer_add_str(char **buffer, int *offset, int *max, const char *text)
+{
+    if (text != NULL) {
+        buffer_add_len(buffer, offset, max, text, strlen(text));
+    }
+}
 
 static void
 insert_prefix(int options, char **buffer, int *offset, int *max, int depth)
@@ -89,12 +113,10 @@ insert_prefix(int options, char **buffer, int *offset, int *max, int depth)
     if (options & xml_log_option_formatted) {
         size_t spaces = 2 * depth;
 
-        if ((*buffer) == NULL || spaces >= ((*max) - (*offset))) {
-            (*max) = QB_MAX(CHUNK_SIZE, (*max) * 2);
-            (*buffer) = pcmk__realloc((*buffer), (*max));
-        }
+        buffer_reserve(buffer, *offset, max, spaces);
         memset((*buffer) + (*offset), ' ', spaces);
         (*offset) += spaces;
+        (*buffer)[*offset] = '\0';
     }
 }
 
@@ -1315,21 +1337,73 @@ write_xml_file(xmlNode * xml_node, const char *filename, gboolean compress)
     return (int) nbytes;
 }
 
-// Replace a portion of a dynamically allocated string (reallocating memory)
-static char *
-replace_text(char *text, int start, size_t *length, const char *replace)
+/*!
+ * \internal
+ * \brief Add text to a buffer, replacing special characters with XML escapes
+ *
+ * \param[in,out] buffer  Buffer to store text in (may be reallocated)
+ * \param[in,out] offset  Current position of null terminator within \p buffer
+ * \param[in,out] max     Current size of \p buffer in bytes
+ * \param[in]     text    Text to escape and add
+ *
+ * \note Runs of characters that need no escaping are copied as a block, so
+ *       nothing is allocated unless the buffer needs to grow.
+ */
+static void
+buffer_add_escaped(char **buffer, int *offset, int *max, const char *text)
 {
-    size_t offset = strlen(replace) - 1; // We have space for 1 char already
+    const char *run = text; // Start of characters not yet added
 
-    *length += offset;
-    text = pcmk__realloc(text, *length);
+    for (const char *c = text; *c != '\0'; c++) {
+        const char *replace = NULL;
+        char octal[16];
 
-    for (size_t lpc = (*length) - 1; lpc > (start + offset); lpc--) {
-        text[lpc] = text[lpc - offset];
-    }
+        if ((c[0] & 0x80) && (c[1] & 0x80)) {
+            break; // Leave multibyte characters (and anything after) alone
+        }
 
-    memcpy(text + start, replace, offset + 1);
-    return text;
+        switch (*c) {
+            case '<':
+                replace = "&lt;";
+                break;
+            case '>':
+                replace = "&gt;";
+                break;
+            case '"':
+                replace = "&quot;";
+                break;
+            case '\'':
+                replace = "&apos;";
+                break;
+            case '&':
+                replace = "&amp;";
+                break;
+            case '\t':
+                /* Might as well just expand to a few spaces... */
+                replace = "    ";
+                break;
+            case '\n':
+                replace = "\\n";
+                break;
+            case '\r':
+                replace = "\\r";
+                break;
+            default:
+                /* Check for and replace non-printing characters with their octal equivalent */
+                if ((*c < ' ') || (*c > '~')) {
+                    snprintf(octal, sizeof(octal), "\\%.3o", *c);
+                    replace = octal;
+                }
+                break;
+        }
+
+        if (replace != NULL) {
+            buffer_add_len(buffer, offset, max, run, c - run);
+            buffer_add_str(buffer, offset, max, replace);
+            run = c + 1;
+        }
+    }
+    buffer_add_str(buffer, offset, max, run);
 }
 
 /*!
@@ -1344,8 +1418,9 @@ replace_text(char *text, int start, size_t *length, const char *replace)
 char *
 crm_xml_escape(const char *text)
 {
-    size_t length;
-    char *copy;
+    char *buffer = NULL;
+    int offset = 0;
+    int max = 0;
 
     /*
      * When xmlCtxtReadDoc() parses &lt; and friends in a
@@ -1366,59 +1441,19 @@ crm_xml_escape(const char *text)
         return NULL;
     }
 
-    length = 1 + strlen(text);
-    copy = strdup(text);
-    CRM_ASSERT(copy != NULL);
-    for (size_t index = 0; index < length; index++) {
-        if(copy[index] & 0x80 && copy[index+1] & 0x80){
-            index++;
-            break;
-        }
-        switch (copy[index]) {
-            case 0:
-                break;
-            case '<':
-                copy = replace_text(copy, index, &length, "&lt;");
-                break;
-            case '>':
-                copy = replace_text(copy, index, &length, "&gt;");
-                break;
-            case '"':
-                copy = replace_text(copy, index, &length, "&quot;");
-                break;
-            case '\'':
-                copy = replace_text(copy, index, &length, "&apos;");
-                break;
-            case '&':
-                copy = replace_text(copy, index, &length, "&amp;");
-                break;
-            case '\t':
-                /* Might as well just expand to a few spaces... */
-                copy = replace_text(copy, index, &length, "    ");
-                break;
-            case '\n':
-                copy = replace_text(copy, index, &length, "\\n");
-                break;
-            case '\r':
-                copy = replace_text(copy, index, &length, "\\r");
-                break;
-            default:
-                /* Check for and replace non-printing characters with their octal equivalent */
-                if(copy[index] < ' ' || copy[index] > '~') {
-                    char *replace = crm_strdup_printf("\\%.3o", copy[index]);
+    // Most text needs little or no escaping, so start with the same size
+    max = strlen(text) + 1;
+    buffer = calloc(1, max);
+    CRM_ASSERT(buffer != NULL);
 
-                    copy = replace_text(copy, index, &length, replace);
-                    free(replace);
-                }
-        }
-    }
-    return copy;
+    buffer_add_escaped(&buffer, &offset, &max, text);
+    return buffer;
 }
 
 static inline void
 dump_xml_attr(xmlAttrPtr attr, int options, char **buffer, int *offset, int *max)
 {
-    char *p_value = NULL;
+    const char *p_value = NULL;
     const char *p_name = NULL;
     xml_private_t *p = NULL;
 
@@ -1433,10 +1468,17 @@ dump_xml_attr(xmlAttrPtr attr, int options, char **buffer, int *offset, int *max
     }
 
     p_name = (const char *)attr->name;
-    p_value = crm_xml_escape((const char *)attr->children->content);
-    buffer_print(*buffer, *max, *offset, " %s=\"%s\"",
-                 p_name, crm_str(p_value));
-    free(p_value);
+    p_value = (const char *)attr->children->content;
+
+    buffer_add_len(buffer, offset, max, " ", 1);
+    buffer_add_str(buffer, offset, max, p_name);
+    buffer_add_len(buffer, offset, max, "=\"", 2);
+    if (p_value == NULL) {
+        buffer_add_str(buffer, offset, max, crm_str(p_value));
+    } else {
+        buffer_add_escaped(buffer, offset, max, p_value);
+    }
+    buffer_add_len(buffer, offset, max, "\"", 1);
 }
 
 // Log an XML element (and any children) in a formatted way
@@ -1463,10 +1505,14 @@ pcmk__xe_log(int log_level, const char *file, const char *function, int line,
         insert_prefix(options, &buffer, &offset, &max, depth);
 
         if (data->type == XML_COMMENT_NODE) {
-            buffer_print(buffer, max, offset, "<!--%s-->", data->content);
+            buffer_add_str(&buffer, &offset, &max, "<!--");
+            buffer_add_str(&buffer, &offset, &max,
+                           (const char *) data->content);
+            buffer_add_str(&buffer, &offset, &max, "-->");
 
         } else {
-            buffer_print(buffer, max, offset, "<%s", name);
+            buffer_add_str(&buffer, &offset, &max, "<");
+            buffer_add_str(&buffer, &offset, &max, name);
 
             hidden = crm_element_value(data, "hidden");
             for (xmlAttrPtr a = pcmk__xe_first_attr(data); a != NULL;
@@ -1475,7 +1521,6 @@ pcmk__xe_log(int log_level, const char *file, const char *function, int line,
                 xml_private_t *p = a->_private;
                 const char *p_name = (const char *) a->name;
                 const char *p_value = pcmk__xml_attr_value(a);
-                char *p_copy = NULL;
 
                 if (pcmk_is_set(p->flags, pcmk__xf_deleted)) {
                     continue;
@@ -1484,27 +1529,31 @@ pcmk__xe_log(int log_level, const char *file, const char *function, int line,
                                               |xml_log_option_diff_minus)
                            && (strcmp(XML_DIFF_MARKER, p_name) == 0)) {
                     continue;
+                }
+
+                buffer_add_str(&buffer, &offset, &max, " ");
+                buffer_add_str(&buffer, &offset, &max, p_name);
+                buffer_add_str(&buffer, &offset, &max, "=\"");
+                if (hidden != NULL && p_name[0] != 0 && strstr(hidden, p_name) != NULL) {
+                    buffer_add_str(&buffer, &offset, &max, "*****");
 
-                } else if (hidden != NULL && p_name[0] != 0 && strstr(hidden, p_name) != NULL) {
-                    p_copy = strdup("*****");
+                } else if (p_value == NULL) {
+                    buffer_add_str(&buffer, &offset, &max, crm_str(p_value));
 
                 } else {
-                    p_copy = crm_xml_escape(p_value);
+                    buffer_add_escaped(&buffer, &offset, &max, p_value);
                 }
-
-                buffer_print(buffer, max, offset, " %s=\"%s\"",
-                             p_name, crm_str(p_copy));
-                free(p_copy);
+                buffer_add_str(&buffer, &offset, &max, "\"");
             }
 
             if(xml_has_children(data) == FALSE) {
-                buffer_print(buffer, max, offset, "/>");
+                buffer_add_str(&buffer, &offset, &max, "/>");
 
             } else if (pcmk_is_set(options, xml_log_option_children)) {
-                buffer_print(buffer, max, offset, ">");
+                buffer_add_str(&buffer, &offset, &max, ">");
 
             } else {
-                buffer_print(buffer, max, offset, "/>");
+                buffer_add_str(&buffer, &offset, &max, "/>");
             }
         }
 
@@ -1533,8 +1582,12 @@ pcmk__xe_log(int log_level, const char *file, const char *function, int line,
     if (pcmk_is_set(options, xml_log_option_close)) {
         char *buffer = NULL;
 
+        offset = 0;
+        max = 0;
         insert_prefix(options, &buffer, &offset, &max, depth);
-        buffer_print(buffer, max, offset, "</%s>", name);
+        buffer_add_str(&buffer, &offset, &max, "</");
+        buffer_add_str(&buffer, &offset, &max, name);
+        buffer_add_str(&buffer, &offset, &max, ">");
 
         do_crm_log_alias(log_level, file, function, line, "%s %s", prefix, buffer);
         free(buffer);
@@ -1736,7 +1789,8 @@ dump_xml_element(xmlNode * data, int options, char **buffer, int *offset, int *m
     CRM_ASSERT(name != NULL);
 
     insert_prefix(options, buffer, offset, max, depth);
-    buffer_print(*buffer, *max, *offset, "<%s", name);
+    buffer_add_len(buffer, offset, max, "<", 1);
+    buffer_add_str(buffer, offset, max, name);
 
     if (options & xml_log_option_filtered) {
         dump_filtered_xml(data, options, buffer, offset, max);
@@ -1748,14 +1802,14 @@ dump_xml_element(xmlNode * data, int options, char **buffer, int *offset, int *m
     }
 
     if (data->children == NULL) {
-        buffer_print(*buffer, *max, *offset, "/>");
+        buffer_add_len(buffer, offset, max, "/>", 2);
 
     } else {
-        buffer_print(*buffer, *max, *offset, ">");
+        buffer_add_len(buffer, offset, max, ">", 1);
     }
 
     if (options & xml_log_option_formatted) {
-        buffer_print(*buffer, *max, *offset, "\n");
+        buffer_add_len(buffer, offset, max, "\n", 1);
     }
 
     if (data->children) {
@@ -1765,10 +1819,12 @@ dump_xml_element(xmlNode * data, int options, char **buffer, int *offset, int *m
         }
 
         insert_prefix(options, buffer, offset, max, depth);
-        buffer_print(*buffer, *max, *offset, "</%s>", name);
+        buffer_add_len(buffer, offset, max, "</", 2);
+        buffer_add_str(buffer, offset, max, name);
+        buffer_add_len(buffer, offset, max, ">", 1);
 
         if (options & xml_log_option_formatted) {
-            buffer_print(*buffer, *max, *offset, "\n");
+            buffer_add_len(buffer, offset, max, "\n", 1);
         }
     }
 }
@@ -1792,10 +1848,10 @@ dump_xml_text(xmlNode * data, int options, char **buffer, int *offset, int *max,
 
     insert_prefix(options, buffer, offset, max, depth);
 
-    buffer_print(*buffer, *max, *offset, "%s", data->content);
+    buffer_add_str(buffer, offset, max, (const char *) data->content);
 
     if (options & xml_log_option_formatted) {
-        buffer_print(*buffer, *max, *offset, "\n");
+        buffer_add_len(buffer, offset, max, "\n", 1);
     }
 }
 
@@ -1818,12 +1874,12 @@ dump_xml_cdata(xmlNode * data, int options, char **buffer, int *offset, int *max
 
     insert_prefix(options, buffer, offset, max, depth);
 
-    buffer_print(*buffer, *max, *offset, "<![CDATA[");
-    buffer_print(*buffer, *max, *offset, "%s", data->content);
-    buffer_print(*buffer, *max, *offset, "]]>");
+    buffer_add_str(buffer, offset, max, "<![CDATA[");
+    buffer_add_str(buffer, offset, max, (const char *) data->content);
+    buffer_add_str(buffer, offset, max, "]]>");
 
     if (options & xml_log_option_formatted) {
-        buffer_print(*buffer, *max, *offset, "\n");
+        buffer_add_len(buffer, offset, max, "\n", 1);
     }
 }
 
@@ -1846,12 +1902,12 @@ dump_xml_comment(xmlNode * data, int options, char **buffer, int *offset, int *m
 
     insert_prefix(options, buffer, offset, max, depth);
 
-    buffer_print(*buffer, *max, *offset, "<!--");
-    buffer_print(*buffer, *max, *offset, "%s", data->content);
-    buffer_print(*buffer, *max, *offset, "-->");
+    buffer_add_str(buffer, offset, max, "<!--");
+    buffer_add_str(buffer, offset, max, (const char *) data->content);
+    buffer_add_str(buffer, offset, max, "-->");
 
     if (options & xml_log_option_formatted) {
-        buffer_print(*buffer, *max, *offset, "\n");
+        buffer_add_len(buffer, offset, max, "\n", 1);
     }
 }
 
@@ -1915,8 +1971,9 @@ pcmk__xml2text(xmlNode *data, int options, char **buffer, int *offset,
         /* attempt adding final NL - failing shouldn't be fatal here */
         (void) xmlOutputBufferWrite(xml_buffer, sizeof("\n") - 1, "\n");
         if (xml_buffer->buffer != NULL) {
-            buffer_print(*buffer, *max, *offset, "%s",
-                         (char *) xmlBufContent(xml_buffer->buffer));
+            buffer_add_len(buffer, offset, max,
+                           (const char *) xmlBufContent(xml_buffer->buffer),
+                           xmlBufUse(xml_buffer->buffer));
         }
 
 #if (PCMK__XMLDUMP_STATS - 0)
@@ -1988,7 +2045,7 @@ pcmk__xml2text(xmlNode *data, int options, char **buffer, int *offset,
 void
 pcmk__buffer_add_char(char **buffer, int *offset, int *max, char c)
 {
-    buffer_print(*buffer, *max, *offset, "%c", c);
+    buffer_add_len(buffer, offset, max, &c, 1);
 }
 
 char *
@@ -329,3 +329,104 @@ pcmk__xpath_node_id(const char *xpath, const char *node)
     free(patt);
     return retval;
 }
+
+/*!
+ * \internal
+ * \brief Get the length of the first step of a path
+ *
+ * \param[in] path  Path (without leading slash)
+ *
+ * \return Length of first step of \p path (not counting any following slash)
+ */
+static size_t
+path_step_len(const char *path)
+{
+    bool in_predicate = false;
+    size_t len = 0;
+
+    for (; path[len] != '\0'; len++) {
+        if (path[len] == '[') {
+            in_predicate = true;
+        } else if (path[len] == ']') {
+            in_predicate = false;
+        } else if ((path[len] == '/') && !in_predicate) {
+            break;
+        }
+    }
+    return len;
+}
+
+/*!
+ * \internal
+ * \brief Check whether two path steps could refer to the same element
+ *
+ * \param[in] step1  First step
+ * \param[in] len1   Length of \p step1
+ * \param[in] step2  Second step
+ * \param[in] len2   Length of \p step2
+ *
+ * \return true if the steps have the same element name and either one has
+ *         no predicate or both have the same predicate, otherwise false
+ */
+static bool
+path_steps_match(const char *step1, size_t len1, const char *step2,
+                 size_t len2)
+{
+    size_t name1 = strcspn(step1, "[/");
+    size_t name2 = strcspn(step2, "[/");
+
+    name1 = QB_MIN(name1, len1);
+    name2 = QB_MIN(name2, len2);
+    if ((name1 != name2) || (strncmp(step1, step2, name1) != 0)) {
+        return false;
+    }
+    if ((name1 == len1) || (name2 == len2)) {
+        return true; // At least one step has no predicate
+    }
+    return (len1 == len2) && (strncmp(step1, step2, len1) == 0);
+}
+
+/*!
+ * \internal
+ * \brief Check whether an element path is at or below another
+ *
+ * \param[in] path      Absolute element path, in the form built by
+ *                      pcmk__element_xpath()
+ * \param[in] ancestor  Absolute element path to check against, in same form
+ *
+ * \return true if every step of \p ancestor matches the corresponding step of
+ *         \p path, otherwise false
+ * \note A step with no ID predicate (such as "node_state") matches an element
+ *       of that name with any ID (such as "node_state[@id='1']"), so
+ *       "/cib/status/node_state" is within "/cib/status" and contains
+ *       "/cib/status/node_state[@id='1']/lrm[@id='1']".
+ */
+bool
+pcmk__xpath_within(const char *path, const char *ancestor)
+{
+    CRM_CHECK((path != NULL) && (ancestor != NULL), return false);
+
+    while (*ancestor != '\0') {
+        size_t path_len = 0;
+        size_t ancestor_len = 0;
+
+        if (*path != '/') {
+            return false; // Path has fewer steps than ancestor
+        }
+        if (*ancestor != '/') {
+            return false; // Not an absolute path
+        }
+        path++;
+        ancestor++;
+
+        path_len = path_step_len(path);
+        ancestor_len = path_step_len(ancestor);
+        if ((ancestor_len == 0) // Trailing slash
+            || !path_steps_match(path, path_len, ancestor, ancestor_len)) {
+            return false;
+        }
+        path += path_len;
+        ancestor += ancestor_len;
+    }
+    return true;
+}
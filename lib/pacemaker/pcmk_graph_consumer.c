@@ -29,12 +29,10 @@
  * \brief Update synapse after completed prerequisite
  *
  * A synapse is ready to be executed once all its prerequisite actions (inputs)
- * complete. Given a completed action, check whether it is an input for a given
- * synapse, and if so, mark the input as confirmed, and mark the synapse as
- * ready if appropriate.
+ * complete. Given a synapse input for a completed action, mark the input as
+ * confirmed, and mark the synapse as ready if appropriate.
  *
- * \param[in] synapse    Transition graph synapse to update
- * \param[in] action_id  ID of an action that completed
+ * \param[in] input  Synapse input corresponding to an action that completed
  *
  * \note The only substantial effect here is confirming synapse inputs.
  *       should_fire_synapse() will recalculate pcmk__synapse_ready, so the only
@@ -42,28 +40,25 @@
  *       synapse_state_str().
  */
 static void
-update_synapse_ready(synapse_t *synapse, int action_id)
+update_synapse_ready(crm_action_t *input)
 {
+    synapse_t *synapse = input->synapse;
+
     if (pcmk_is_set(synapse->flags, pcmk__synapse_ready)) {
         return; // All inputs have already been confirmed
     }
-    pcmk__set_synapse_flags(synapse, pcmk__synapse_ready); // Presume ready until proven otherwise
-    for (GList *lpc = synapse->inputs; lpc != NULL; lpc = lpc->next) {
-        crm_action_t *prereq = (crm_action_t *) lpc->data;
-
-        if (prereq->id == action_id) {
-            crm_trace("Confirming input %d of synapse %d",
-                      action_id, synapse->id);
-            crm__set_graph_action_flags(prereq, pcmk__graph_action_confirmed);
-
-        } else if (!(pcmk_is_set(prereq->flags, pcmk__graph_action_confirmed))) {
-            pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
-            crm_trace("Synapse %d still not ready after action %d",
-                      synapse->id, action_id);
-        }
+    if (!pcmk_is_set(input->flags, pcmk__graph_action_confirmed)) {
+        crm_trace("Confirming input %d of synapse %d",
+                  input->id, synapse->id);
+        crm__set_graph_action_flags(input, pcmk__graph_action_confirmed);
+        synapse->unconfirmed_inputs--;
     }
-    if (pcmk_is_set(synapse->flags, pcmk__synapse_ready)) {
+    if (synapse->unconfirmed_inputs > 0) {
+        crm_trace("Synapse %d still not ready after action %d",
+                  synapse->id, input->id);
+    } else {
         crm_trace("Synapse %d is now ready to execute", synapse->id);
+        pcmk__set_synapse_flags(synapse, pcmk__synapse_ready);
     }
 }
 
@@ -110,17 +105,37 @@ update_synapse_confirmed(synapse_t *synapse, int action_id)
 void
 pcmk__update_graph(crm_graph_t *graph, crm_action_t *action)
 {
-    for (GList *lpc = graph->synapses; lpc != NULL; lpc = lpc->next) {
-        synapse_t *synapse = (synapse_t *) lpc->data;
+    crm_action_t *graph_action = NULL;
+    GList *inputs = NULL;
+
+    // Update the synapse that the action belongs to
+    graph_action = g_hash_table_lookup(graph->actions_by_id,
+                                       GINT_TO_POINTER(action->id));
+    if (graph_action != NULL) {
+        synapse_t *synapse = graph_action->synapse;
+
+        if (!pcmk_any_flags_set(synapse->flags,
+                                pcmk__synapse_confirmed|pcmk__synapse_failed)
+            && pcmk_is_set(synapse->flags, pcmk__synapse_executed)) {
+            update_synapse_confirmed(synapse, action->id);
+        }
+    }
 
-        if (pcmk_any_flags_set(synapse->flags, pcmk__synapse_confirmed|pcmk__synapse_failed)) {
-            continue; // This synapse already completed
+    // Update the synapses that have the action as an input
+    inputs = g_hash_table_lookup(graph->inputs_by_id,
+                                 GINT_TO_POINTER(action->id));
+    for (GList *lpc = inputs; lpc != NULL; lpc = lpc->next) {
+        crm_action_t *input = (crm_action_t *) lpc->data;
+        synapse_t *synapse = input->synapse;
 
-        } else if (pcmk_is_set(synapse->flags, pcmk__synapse_executed)) {
-            update_synapse_confirmed(synapse, action->id);
+        if (pcmk_any_flags_set(synapse->flags,
+                               pcmk__synapse_confirmed|pcmk__synapse_failed
+                               |pcmk__synapse_executed)) {
+            continue; // This synapse already completed or was executed
 
-        } else if (!(pcmk_is_set(action->flags, pcmk__graph_action_failed)) || (synapse->priority == INFINITY)) {
-            update_synapse_ready(synapse, action->id);
+        } else if (!(pcmk_is_set(action->flags, pcmk__graph_action_failed))
+                   || (synapse->priority == INFINITY)) {
+            update_synapse_ready(input);
         }
     }
 }
@@ -169,17 +184,20 @@ should_fire_synapse(crm_graph_t *graph, synapse_t *synapse)
 {
     GList *lpc = NULL;
 
+    if (synapse->unconfirmed_inputs > 0) {
+        crm_trace("%d input%s for synapse %d not yet confirmed",
+                  synapse->unconfirmed_inputs,
+                  pcmk__plural_s(synapse->unconfirmed_inputs), synapse->id);
+        pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
+        return false;
+    }
+
+    // All inputs are confirmed, but any may have failed
     pcmk__set_synapse_flags(synapse, pcmk__synapse_ready);
     for (lpc = synapse->inputs; lpc != NULL; lpc = lpc->next) {
         crm_action_t *prereq = (crm_action_t *) lpc->data;
 
-        if (!(pcmk_is_set(prereq->flags, pcmk__graph_action_confirmed))) {
-            crm_trace("Input %d for synapse %d not yet confirmed",
-                      prereq->id, synapse->id);
-            pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
-            break;
-
-        } else if (pcmk_is_set(prereq->flags, pcmk__graph_action_failed) && !(pcmk_is_set(prereq->flags, pcmk__graph_action_can_fail))) {
+        if (pcmk_is_set(prereq->flags, pcmk__graph_action_failed) && !(pcmk_is_set(prereq->flags, pcmk__graph_action_can_fail))) {
             crm_trace("Input %d for synapse %d confirmed but failed",
                       prereq->id, synapse->id);
             pcmk__clear_synapse_flags(synapse, pcmk__synapse_ready);
@@ -547,6 +565,92 @@ unpack_action(synapse_t *parent, xmlNode *xml_action)
     return action;
 }
 
+/*!
+ * \internal
+ * \brief Add an action to a table of action lists
+ *
+ * \param[in,out] table   Table to add action to
+ * \param[in]     key     Table key to add action under
+ * \param[in]     action  Action to add
+ */
+static void
+index_action_by_key(GHashTable *table, const char *key, crm_action_t *action)
+{
+    GList *actions = g_hash_table_lookup(table, key);
+
+    if (actions == NULL) {
+        g_hash_table_insert(table, strdup(key), g_list_append(NULL, action));
+    } else {
+        // Appending to a non-empty list doesn't change its head
+        g_list_append(actions, action);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Add a synapse action to a transition graph's lookup tables
+ *
+ * \param[in,out] graph   Transition graph that action is part of
+ * \param[in]     action  Action to add
+ */
+static void
+index_graph_action(crm_graph_t *graph, crm_action_t *action)
+{
+    const char *task = crm_element_value(action->xml, XML_LRM_ATTR_TASK);
+    xmlNode *downed = first_named_child(action->xml, XML_GRAPH_TAG_DOWNED);
+
+    // If IDs are duplicated (which shouldn't happen), the first one wins
+    if (!g_hash_table_contains(graph->actions_by_id,
+                               GINT_TO_POINTER(action->id))) {
+        g_hash_table_insert(graph->actions_by_id, GINT_TO_POINTER(action->id),
+                            action);
+    }
+
+    if (pcmk__str_eq(task, CRMD_ACTION_CANCEL, pcmk__str_casei)) {
+        const char *key = crm_element_value(action->xml,
+                                            XML_LRM_ATTR_TASK_KEY);
+
+        if (key != NULL) {
+            index_action_by_key(graph->cancels_by_key, key, action);
+        }
+    }
+
+    for (xmlNode *node = first_named_child(downed, XML_CIB_TAG_NODE);
+         node != NULL; node = crm_next_same_xml(node)) {
+
+        const char *uuid = crm_element_value(node, XML_ATTR_UUID);
+
+        if (uuid != NULL) {
+            index_action_by_key(graph->downed_by_node, uuid, action);
+        }
+    }
+}
+
+/*!
+ * \internal
+ * \brief Add a synapse input to a transition graph's lookup table
+ *
+ * \param[in,out] graph  Transition graph that input's synapse is part of
+ * \param[in]     input  Input to add
+ */
+static void
+index_synapse_input(crm_graph_t *graph, crm_action_t *input)
+{
+    gpointer key = GINT_TO_POINTER(input->id);
+    GList *inputs = g_hash_table_lookup(graph->inputs_by_id, key);
+
+    if (inputs == NULL) {
+        g_hash_table_insert(graph->inputs_by_id, key,
+                            g_list_prepend(NULL, input));
+    } else {
+        /* Order doesn't matter here, and actions can be inputs for very many
+         * synapses, so insert after the first item (keeping the list's head)
+         * rather than append
+         */
+        g_list_insert(inputs, input, 1);
+    }
+}
+
 /*!
  * \internal
  * \brief Unpack transition graph synapse from XML
@@ -600,6 +704,7 @@ unpack_synapse(crm_graph_t *new_graph, xmlNode *xml_synapse)
             new_graph->num_actions++;
             new_synapse->actions = g_list_append(new_synapse->actions,
                                                  new_action);
+            index_graph_action(new_graph, new_action);
         }
     }
 
@@ -625,6 +730,8 @@ unpack_synapse(crm_graph_t *new_graph, xmlNode *xml_synapse)
 
                 new_synapse->inputs = g_list_append(new_synapse->inputs,
                                                     new_input);
+                new_synapse->unconfirmed_inputs++;
+                index_synapse_input(new_graph, new_input);
             }
         }
     }
@@ -712,6 +819,14 @@ pcmk__unpack_graph(xmlNode *xml_graph, const char *reference)
         pcmk__scan_min_int(t_id, &(new_graph->migration_limit), -1);
     }
 
+    new_graph->actions_by_id = g_hash_table_new(NULL, NULL);
+    new_graph->cancels_by_key =
+        pcmk__strikey_table(free, (GDestroyNotify) g_list_free);
+    new_graph->downed_by_node =
+        pcmk__strkey_table(free, (GDestroyNotify) g_list_free);
+    new_graph->inputs_by_id =
+        g_hash_table_new_full(NULL, NULL, NULL, (GDestroyNotify) g_list_free);
+
     // Unpack each child <synapse> element
     for (xmlNode *synapse_xml = first_named_child(xml_graph, "synapse");
          synapse_xml != NULL; synapse_xml = crm_next_same_xml(synapse_xml)) {
@@ -785,6 +900,18 @@ void
 pcmk__free_graph(crm_graph_t *graph)
 {
     if (graph != NULL) {
+        if (graph->actions_by_id != NULL) {
+            g_hash_table_destroy(graph->actions_by_id);
+        }
+        if (graph->cancels_by_key != NULL) {
+            g_hash_table_destroy(graph->cancels_by_key);
+        }
+        if (graph->downed_by_node != NULL) {
+            g_hash_table_destroy(graph->downed_by_node);
+        }
+        if (graph->inputs_by_id != NULL) {
+            g_hash_table_destroy(graph->inputs_by_id);
+        }
         g_list_free_full(graph->synapses, free_graph_synapse);
         free(graph->source);
         free(graph);
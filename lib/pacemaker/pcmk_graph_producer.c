@@ -989,6 +989,20 @@ pcmk__log_transition_summary(const char *filename)
     }
 }
 
+/*!
+ * \internal
+ * \brief Give a previously created transition graph the next transition ID
+ *
+ * \param[in,out] graph  Transition graph XML to renumber
+ */
+void
+pcmk__renumber_graph(xmlNode *graph)
+{
+    transition_id++;
+    crm_trace("Reusing transition graph as %d", transition_id);
+    crm_xml_add_int(graph, "transition_id", transition_id);
+}
+
 /*!
  * \internal
  * \brief Create a transition graph with all cluster actions needed
@@ -662,34 +662,90 @@ pacemakerd_health_xml(pcmk__output_t *out, va_list args)
     return pcmk_rc_ok;
 }
 
-PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t")
+PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t",
+                  "pcmk__sched_profile_t *")
 static int
 profile_default(pcmk__output_t *out, va_list args) {
     const char *xml_file = va_arg(args, const char *);
     clock_t start = va_arg(args, clock_t);
     clock_t end = va_arg(args, clock_t);
+    pcmk__sched_profile_t *profile = va_arg(args, pcmk__sched_profile_t *);
 
     out->list_item(out, NULL, "Testing %s ... %.2f secs", xml_file,
                    (end - start) / (float) CLOCKS_PER_SEC);
 
+    if (profile == NULL) {
+        return pcmk_rc_ok;
+    }
+
+    out->begin_list(out, NULL, NULL, "Phases for %s", xml_file);
+    for (int phase = 0; phase < pcmk__phase_max; phase++) {
+        out->list_item(out, NULL, "%s: %.3f secs (%.3f secs CPU)",
+                       pcmk__sched_phase_name(phase), profile->wall[phase],
+                       profile->cpu[phase]);
+    }
+    out->list_item(out, NULL,
+                   "%u resources, %u nodes, %u actions, %u orderings, "
+                   "%u colocations, %u locations, %u synapses",
+                   profile->resources, profile->nodes, profile->actions,
+                   profile->orderings, profile->colocations,
+                   profile->locations, profile->synapses);
+    out->list_item(out, NULL, "Peak RSS: %ld KiB", profile->peak_rss_kb);
+    out->end_list(out);
     return pcmk_rc_ok;
 }
 
-PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t")
+PCMK__OUTPUT_ARGS("profile", "const char *", "clock_t", "clock_t",
+                  "pcmk__sched_profile_t *")
 static int
 profile_xml(pcmk__output_t *out, va_list args) {
     const char *xml_file = va_arg(args, const char *);
     clock_t start = va_arg(args, clock_t);
     clock_t end = va_arg(args, clock_t);
+    pcmk__sched_profile_t *profile = va_arg(args, pcmk__sched_profile_t *);
 
     char *duration = pcmk__ftoa((end - start) / (float) CLOCKS_PER_SEC);
+    xmlNodePtr counts = NULL;
 
-    pcmk__output_create_xml_node(out, "timing",
-                                 "file", xml_file,
-                                 "duration", duration,
-                                 NULL);
+    if (profile == NULL) {
+        pcmk__output_create_xml_node(out, "timing",
+                                     "file", xml_file,
+                                     "duration", duration,
+                                     NULL);
+        free(duration);
+        return pcmk_rc_ok;
+    }
 
+    pcmk__output_xml_create_parent(out, "timing",
+                                   "file", xml_file,
+                                   "duration", duration,
+                                   NULL);
     free(duration);
+
+    for (int phase = 0; phase < pcmk__phase_max; phase++) {
+        char *wall = pcmk__ftoa(profile->wall[phase]);
+        char *cpu = pcmk__ftoa(profile->cpu[phase]);
+
+        pcmk__output_create_xml_node(out, "phase",
+                                     "name", pcmk__sched_phase_name(phase),
+                                     "duration", wall,
+                                     "cpu", cpu,
+                                     NULL);
+        free(wall);
+        free(cpu);
+    }
+
+    counts = pcmk__output_create_xml_node(out, "counts", NULL);
+    crm_xml_add_int(counts, "resources", (int) profile->resources);
+    crm_xml_add_int(counts, "nodes", (int) profile->nodes);
+    crm_xml_add_int(counts, "actions", (int) profile->actions);
+    crm_xml_add_int(counts, "orderings", (int) profile->orderings);
+    crm_xml_add_int(counts, "colocations", (int) profile->colocations);
+    crm_xml_add_int(counts, "locations", (int) profile->locations);
+    crm_xml_add_int(counts, "synapses", (int) profile->synapses);
+    crm_xml_add_ll(counts, "peak-rss-kb", (long long) profile->peak_rss_kb);
+
+    pcmk__output_xml_pop_parent(out);
     return pcmk_rc_ok;
 }
 
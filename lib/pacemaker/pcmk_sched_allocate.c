@@ -9,6 +9,9 @@
 
 #include <crm_internal.h>
 
+#include <sys/resource.h>   // getrusage()
+#include <time.h>           // clock(), clock_gettime()
+
 #include <crm/crm.h>
 #include <crm/cib.h>
 #include <crm/msg_xml.h>
@@ -743,6 +746,109 @@ unpack_cib(xmlNode *cib, unsigned long long flags, pe_working_set_t *data_set)
     cluster_status(data_set); // Sets pe_flag_have_status
 }
 
+/*!
+ * \internal
+ * \brief Get a readable name for a scheduler phase
+ *
+ * \param[in] phase  Scheduler phase
+ *
+ * \return Name of \p phase
+ */
+const char *
+pcmk__sched_phase_name(enum pcmk__sched_phase phase)
+{
+    switch (phase) {
+        case pcmk__phase_unpack_cib:            return "unpack-cib";
+        case pcmk__phase_node_health:           return "node-health";
+        case pcmk__phase_unpack_constraints:    return "unpack-constraints";
+        case pcmk__phase_node_criteria:         return "node-criteria";
+        case pcmk__phase_internal_constraints:  return "internal-constraints";
+        case pcmk__phase_config_changes:        return "config-changes";
+        case pcmk__phase_allocate:              return "allocate-resources";
+        case pcmk__phase_resource_actions:      return "resource-actions";
+        case pcmk__phase_remote_orderings:      return "remote-orderings";
+        case pcmk__phase_fencing:               return "fencing-and-shutdowns";
+        case pcmk__phase_apply_orderings:       return "apply-orderings";
+        case pcmk__phase_create_graph:          return "create-graph";
+        default:                                return "unknown";
+    }
+}
+
+// Point in time that a scheduler phase started
+typedef struct {
+    struct timespec wall;
+    clock_t cpu;
+} phase_start_t;
+
+/*!
+ * \internal
+ * \brief Record the start of a scheduler phase (if profiling)
+ *
+ * \param[in]  profile  Profile being recorded (or NULL if not profiling)
+ * \param[out] start    Where to store start of phase
+ */
+static void
+start_phase(const pcmk__sched_profile_t *profile, phase_start_t *start)
+{
+    if (profile != NULL) {
+        clock_gettime(CLOCK_MONOTONIC, &(start->wall));
+        start->cpu = clock();
+    }
+}
+
+/*!
+ * \internal
+ * \brief Record the end of a scheduler phase (if profiling)
+ *
+ * \param[in,out] profile  Profile being recorded (or NULL if not profiling)
+ * \param[in]     phase    Phase that ended
+ * \param[in,out] start    Start of phase (will be updated to now, so it can
+ *                         be used as the start of the next phase)
+ */
+static void
+end_phase(pcmk__sched_profile_t *profile, enum pcmk__sched_phase phase,
+          phase_start_t *start)
+{
+    phase_start_t now;
+
+    if (profile == NULL) {
+        return;
+    }
+    start_phase(profile, &now);
+    profile->wall[phase] += (now.wall.tv_sec - start->wall.tv_sec)
+                            + (now.wall.tv_nsec - start->wall.tv_nsec) / 1e9;
+    profile->cpu[phase] += (now.cpu - start->cpu) / (double) CLOCKS_PER_SEC;
+    *start = now;
+}
+
+/*!
+ * \internal
+ * \brief Record object counts and memory usage at the end of a run
+ *
+ * \param[in,out] profile   Profile being recorded (or NULL if not profiling)
+ * \param[in]     data_set  Cluster working set
+ */
+static void
+end_profile(pcmk__sched_profile_t *profile, pe_working_set_t *data_set)
+{
+    struct rusage usage;
+
+    if (profile == NULL) {
+        return;
+    }
+    profile->resources = g_list_length(data_set->resources);
+    profile->nodes = g_list_length(data_set->nodes);
+    profile->actions = g_list_length(data_set->actions);
+    profile->orderings = g_list_length(data_set->ordering_constraints);
+    profile->colocations = g_list_length(data_set->colocation_constraints);
+    profile->locations = g_list_length(data_set->placement_constraints);
+    profile->synapses = (unsigned int) data_set->num_synapse;
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        profile->peak_rss_kb = QB_MAX(profile->peak_rss_kb, usage.ru_maxrss);
+    }
+}
+
 /*!
  * \internal
  * \brief Run the scheduler for a given CIB
@@ -755,11 +861,37 @@ void
 pcmk__schedule_actions(xmlNode *cib, unsigned long long flags,
                        pe_working_set_t *data_set)
 {
+    pcmk__schedule_actions_profiled(cib, flags, data_set, NULL);
+}
+
+/*!
+ * \internal
+ * \brief Run the scheduler for a given CIB, profiling each phase
+ *
+ * \param[in]     cib       CIB XML to use as scheduler input
+ * \param[in]     flags     Working set flags to set in addition to defaults
+ * \param[in,out] data_set  Cluster working set
+ * \param[in,out] profile   If not NULL, add timings and counts to this
+ */
+void
+pcmk__schedule_actions_profiled(xmlNode *cib, unsigned long long flags,
+                                pe_working_set_t *data_set,
+                                pcmk__sched_profile_t *profile)
+{
+    phase_start_t start;
+
+    start_phase(profile, &start);
     unpack_cib(cib, flags, data_set);
+    end_phase(profile, pcmk__phase_unpack_cib, &start);
+
     pcmk__set_allocation_methods(data_set);
     pcmk__apply_node_health(data_set);
+    end_phase(profile, pcmk__phase_node_health, &start);
+
     pcmk__unpack_constraints(data_set);
+    end_phase(profile, pcmk__phase_unpack_constraints, &start);
     if (pcmk_is_set(data_set->flags, pe_flag_check_config)) {
+        end_profile(profile, data_set);
         return;
     }
 
@@ -769,27 +901,43 @@ pcmk__schedule_actions(xmlNode *cib, unsigned long long flags,
     }
 
     apply_node_criteria(data_set);
+    end_phase(profile, pcmk__phase_node_criteria, &start);
 
     if (pcmk_is_set(data_set->flags, pe_flag_quick_location)) {
+        end_profile(profile, data_set);
         return;
     }
 
     pcmk__create_internal_constraints(data_set);
+    end_phase(profile, pcmk__phase_internal_constraints, &start);
+
     pcmk__handle_rsc_config_changes(data_set);
+    end_phase(profile, pcmk__phase_config_changes, &start);
+
     allocate_resources(data_set);
+    end_phase(profile, pcmk__phase_allocate, &start);
+
     schedule_resource_actions(data_set);
+    end_phase(profile, pcmk__phase_resource_actions, &start);
 
     /* Remote ordering constraints need to happen prior to calculating fencing
      * because it is one more place we can mark nodes as needing fencing.
      */
     pcmk__order_remote_connection_actions(data_set);
+    end_phase(profile, pcmk__phase_remote_orderings, &start);
 
     schedule_fencing_and_shutdowns(data_set);
+    end_phase(profile, pcmk__phase_fencing, &start);
+
     pcmk__apply_orderings(data_set);
+    end_phase(profile, pcmk__phase_apply_orderings, &start);
+
     log_all_actions(data_set);
     pcmk__create_graph(data_set);
+    end_phase(profile, pcmk__phase_create_graph, &start);
 
     if (get_crm_log_level() == LOG_TRACE) {
         log_unrunnable_actions(data_set);
     }
+    end_profile(profile, data_set);
 }
@@ -331,6 +331,7 @@ profile_file(const char *xml_file, long long repeat, pe_working_set_t *data_set,
     clock_t start = 0;
     clock_t end;
     unsigned long long data_set_flags = pe_flag_no_compat;
+    pcmk__sched_profile_t profile;
 
     CRM_ASSERT(out != NULL);
 
@@ -358,17 +359,19 @@ profile_file(const char *xml_file, long long repeat, pe_working_set_t *data_set,
         data_set_flags |= pe_flag_show_utilization;
     }
 
+    memset(&profile, 0, sizeof(profile));
     for (int i = 0; i < repeat; ++i) {
         xmlNode *input = (repeat == 1)? cib_object : copy_xml(cib_object);
 
         data_set->input = input;
         set_effective_date(data_set, false, use_date);
-        pcmk__schedule_actions(input, data_set_flags, data_set);
+        pcmk__schedule_actions_profiled(input, data_set_flags, data_set,
+                                        &profile);
         pe_reset_working_set(data_set);
     }
 
     end = clock();
-    out->message(out, "profile", xml_file, start, end);
+    out->message(out, "profile", xml_file, start, end, &profile);
 }
 
 void
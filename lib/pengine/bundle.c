@@ -814,6 +814,7 @@ create_remote_resource(pe_resource_t *parent, pe__bundle_variant_data_t *data,
          */
         g_hash_table_insert(replica->node->details->attrs,
                             strdup(CRM_ATTR_KIND), strdup("container"));
+        pe__clear_failure_index(replica->node, data_set);
 
         /* One effect of this is that setup_container() will add
          * replica->remote to replica->container's fillers, which will make
@@ -158,6 +158,7 @@ pe__create_clone_child(pe_resource_t *rsc, pe_working_set_t *data_set)
     pe_resource_t *child_rsc = NULL;
     xmlNode *child_copy = NULL;
     clone_variant_data_t *clone_data = NULL;
+    pe__ws_index_t *index = NULL;
 
     get_clone_variant_data(clone_data, rsc);
 
@@ -187,6 +188,13 @@ pe__create_clone_child(pe_resource_t *rsc, pe_working_set_t *data_set)
     clone_data->total_clones += 1;
     pe_rsc_trace(child_rsc, "Setting clone attributes for: %s", child_rsc->id);
     rsc->children = g_list_append(rsc->children, child_rsc);
+    index = pe__ws_index(data_set, false);
+    if ((index != NULL) && (index->resources != NULL)
+        && (g_hash_table_lookup(index->resources, uber_parent(rsc)->id)
+            == uber_parent(rsc))) {
+        // The clone is already in the working set, so index the new instance
+        pe__index_resource(data_set, child_rsc);
+    }
     if (as_orphan) {
         pe__set_resource_flags_recursive(child_rsc, pe_rsc_orphan);
     }
@@ -8,7 +8,7 @@
 #include <crm_internal.h>
 
 #include <sys/types.h>
-#include <regex.h>
+#include <ctype.h>
 #include <glib.h>
 
 #include <crm/crm.h>
@@ -16,6 +16,7 @@
 #include <crm/common/xml.h>
 #include <crm/common/util.h>
 #include <crm/pengine/internal.h>
+#include <pe_status_private.h>
 
 static gboolean
 is_matched_failure(const char *rsc_id, xmlNode *conf_op_xml,
@@ -181,102 +182,241 @@ rsc_fail_name(pe_resource_t *rsc)
     return pcmk_is_set(rsc->flags, pe_rsc_unique)? strdup(name) : clone_strip(name);
 }
 
+// Sums of failure-related node attributes for one resource name
+typedef struct {
+    int failcount;  // Sum of fail counts
+    time_t last;    // Most recent last failure
+} failure_totals_t;
+
+// Failure-related node attributes for one node, by resource name
+typedef struct {
+    GHashTable *by_name;    // failure_totals_t* by resource name as used
+    GHashTable *by_base;    // failure_totals_t* by name without instance
+} failure_index_t;
+
+static void
+free_failure_index(gpointer data)
+{
+    failure_index_t *index = data;
+
+    if (index != NULL) {
+        g_hash_table_destroy(index->by_name);
+        g_hash_table_destroy(index->by_base);
+        free(index);
+    }
+}
+
 /*!
  * \internal
- * \brief Compile regular expression to match a failure-related node attribute
+ * \brief Check whether a string ends with an operation name and interval
+ *
+ * \param[in] s  String to check
  *
- * \param[in]  prefix    Attribute prefix to match
- * \param[in]  rsc_name  Resource name to match as used in failure attributes
- * \param[in]  is_legacy Whether DC uses per-resource fail counts
- * \param[in]  is_unique Whether the resource is a globally unique clone
- * \param[out] re        Where to store resulting regular expression
+ * \return true if \p s is nonempty text followed by an underbar and digits
+ */
+static bool
+is_op_spec(const char *s)
+{
+    size_t len = strlen(s);
+    size_t end = len;
+
+    while ((end > 0) && isdigit(s[end - 1])) {
+        --end;
+    }
+    return (end < len) && (end >= 2) && (s[end - 1] == '_');
+}
+
+/*!
+ * \internal
+ * \brief Add a failure-related node attribute value to a table of totals
  *
- * \note Fail attributes are named like PREFIX-RESOURCE#OP_INTERVAL.
- *       The caller is responsible for freeing re with regfree().
+ * \param[in,out] table         Table to add value to
+ * \param[in]     name          Resource name to add value under
+ * \param[in]     is_failcount  Whether value is a fail count (or last failure)
+ * \param[in]     value         Attribute value
  */
 static void
-generate_fail_regex(const char *prefix, const char *rsc_name,
-                    gboolean is_legacy, gboolean is_unique, regex_t *re)
+add_failure_value(GHashTable *table, const char *name, bool is_failcount,
+                  const char *value)
 {
-    char *pattern;
+    failure_totals_t *totals = g_hash_table_lookup(table, name);
 
-    /* @COMPAT DC < 1.1.17: Fail counts used to be per-resource rather than
-     * per-operation.
-     */
-    const char *op_pattern = (is_legacy? "" : "#.+_[0-9]+");
+    if (totals == NULL) {
+        totals = calloc(1, sizeof(failure_totals_t));
+        CRM_ASSERT(totals != NULL);
+        g_hash_table_insert(table, strdup(name), totals);
+    }
 
-    /* Ignore instance numbers for anything other than globally unique clones.
-     * Anonymous clone fail counts could contain an instance number if the
-     * clone was initially unique, failed, then was converted to anonymous.
-     * @COMPAT Also, before 1.1.8, anonymous clone fail counts always contained
-     * clone instance numbers.
-     */
-    const char *instance_pattern = (is_unique? "" : "(:[0-9]+)?");
+    if (is_failcount) {
+        totals->failcount = pcmk__add_scores(totals->failcount,
+                                             char2score(value));
+    } else {
+        long long last_ll;
 
-    pattern = crm_strdup_printf("^%s-%s%s%s$", prefix, rsc_name,
-                                instance_pattern, op_pattern);
-    CRM_LOG_ASSERT(regcomp(re, pattern, REG_EXTENDED|REG_NOSUB) == 0);
-    free(pattern);
+        if (pcmk__scan_ll(value, &last_ll, 0LL) == pcmk_rc_ok) {
+            totals->last = (time_t) QB_MAX(totals->last, last_ll);
+        }
+    }
 }
 
 /*!
  * \internal
- * \brief Compile regular expressions to match failure-related node attributes
+ * \brief Index a node's failure-related attributes by resource name
  *
- * \param[in]  rsc             Resource being checked for failures
- * \param[in]  data_set        Data set (for CRM feature set version)
- * \param[out] failcount_re    Storage for regular expression for fail count
- * \param[out] lastfailure_re  Storage for regular expression for last failure
+ * \param[in] node       Node whose attributes should be indexed
+ * \param[in] is_legacy  Whether DC uses per-resource fail counts
  *
- * \note The caller is responsible for freeing the expressions with regfree().
+ * \return Newly allocated index
+ * \note Fail attributes are named like PREFIX-RESOURCE#OP_INTERVAL, where
+ *       RESOURCE may have a clone instance number (for example, rsc:1).
  */
-static void
-generate_fail_regexes(pe_resource_t *rsc, pe_working_set_t *data_set,
-                      regex_t *failcount_re, regex_t *lastfailure_re)
+static failure_index_t *
+index_failures(pe_node_t *node, bool is_legacy)
 {
-    char *rsc_name = rsc_fail_name(rsc);
-    const char *version = crm_element_value(data_set->input, XML_ATTR_CRM_VERSION);
-    gboolean is_legacy = (compare_version(version, "3.0.13") < 0);
+    GHashTableIter iter;
+    const char *key = NULL;
+    const char *value = NULL;
+    failure_index_t *index = calloc(1, sizeof(failure_index_t));
+
+    CRM_ASSERT(index != NULL);
+    index->by_name = pcmk__strkey_table(free, free);
+    index->by_base = pcmk__strkey_table(free, free);
 
-    generate_fail_regex(PCMK__FAIL_COUNT_PREFIX, rsc_name, is_legacy,
-                        pcmk_is_set(rsc->flags, pe_rsc_unique), failcount_re);
+    g_hash_table_iter_init(&iter, node->details->attrs);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &key,
+                                  (gpointer *) &value)) {
+        bool is_failcount = false;
+        char *name = NULL;
+        char *instance = NULL;
+
+        if (pcmk__starts_with(key, PCMK__FAIL_COUNT_PREFIX "-")) {
+            is_failcount = true;
+            key += sizeof(PCMK__FAIL_COUNT_PREFIX);
+
+        } else if (pcmk__starts_with(key, PCMK__LAST_FAILURE_PREFIX "-")) {
+            key += sizeof(PCMK__LAST_FAILURE_PREFIX);
+
+        } else {
+            continue;
+        }
 
-    generate_fail_regex(PCMK__LAST_FAILURE_PREFIX, rsc_name, is_legacy,
-                        pcmk_is_set(rsc->flags, pe_rsc_unique), lastfailure_re);
+        /* @COMPAT DC < 1.1.17: Fail counts used to be per-resource rather than
+         * per-operation.
+         */
+        if (is_legacy) {
+            name = strdup(key);
+            CRM_ASSERT(name != NULL);
+
+        } else {
+            const char *op = strchr(key, '#');
+
+            if ((op == NULL) || !is_op_spec(op + 1)) {
+                continue;
+            }
+            name = strndup(key, op - key);
+            CRM_ASSERT(name != NULL);
+        }
 
+        add_failure_value(index->by_name, name, is_failcount, value);
+
+        /* Ignore instance numbers for anything other than globally unique
+         * clones. Anonymous clone fail counts could contain an instance number
+         * if the clone was initially unique, failed, then was converted to
+         * anonymous. @COMPAT Also, before 1.1.8, anonymous clone fail counts
+         * always contained clone instance numbers.
+         */
+        instance = strrchr(name, ':');
+        if ((instance != NULL) && (instance[1] != '\0')
+            && (strspn(instance + 1, "0123456789") == strlen(instance + 1))) {
+            *instance = '\0';
+        }
+        add_failure_value(index->by_base, name, is_failcount, value);
+        free(name);
+    }
+    return index;
+}
+
+/*!
+ * \internal
+ * \brief Discard a node's failure attribute index, if any
+ *
+ * \param[in] node      Node whose attributes have been added or replaced
+ * \param[in] data_set  Cluster working set
+ *
+ * \note This must be called whenever a node attribute is added or replaced
+ *       after the node is created, so the index is rebuilt on next use.
+ */
+void
+pe__clear_failure_index(const pe_node_t *node,
+                        const pe_working_set_t *data_set)
+{
+    pe__ws_index_t *ws_index = pe__ws_index(data_set, false);
+
+    if ((ws_index != NULL) && (ws_index->failures != NULL)) {
+        g_hash_table_remove(ws_index->failures, node->details);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Get a resource's failure totals from a node's attributes
+ *
+ * \param[in] node      Node to check
+ * \param[in] rsc       Resource to check
+ * \param[in] data_set  Cluster working set
+ *
+ * \return Failure totals for \p rsc on \p node (or NULL if none)
+ * \note Each node's attributes are indexed on first use, so this is a table
+ *       lookup rather than a search of all attributes. The index is kept
+ *       until pe__clear_failure_index() is called for the node.
+ */
+static const failure_totals_t *
+get_failure_totals(pe_node_t *node, pe_resource_t *rsc,
+                   pe_working_set_t *data_set)
+{
+    pe__ws_index_t *ws_index = pe__ws_index(data_set, true);
+    failure_index_t *index = NULL;
+    char *rsc_name = NULL;
+    const failure_totals_t *totals = NULL;
+
+    if (ws_index->failures == NULL) {
+        ws_index->failures = g_hash_table_new_full(NULL, NULL, NULL,
+                                                   free_failure_index);
+    }
+
+    index = g_hash_table_lookup(ws_index->failures, node->details);
+    if (index == NULL) {
+        const char *version = crm_element_value(data_set->input,
+                                                XML_ATTR_CRM_VERSION);
+
+        index = index_failures(node, (compare_version(version, "3.0.13") < 0));
+        g_hash_table_insert(ws_index->failures, node->details, index);
+    }
+
+    rsc_name = rsc_fail_name(rsc);
+    if (pcmk_is_set(rsc->flags, pe_rsc_unique)) {
+        totals = g_hash_table_lookup(index->by_name, rsc_name);
+    } else {
+        totals = g_hash_table_lookup(index->by_base, rsc_name);
+    }
     free(rsc_name);
+    return totals;
 }
 
 int
 pe_get_failcount(pe_node_t *node, pe_resource_t *rsc, time_t *last_failure,
                  uint32_t flags, xmlNode *xml_op, pe_working_set_t *data_set)
 {
-    char *key = NULL;
-    const char *value = NULL;
-    regex_t failcount_re, lastfailure_re;
     int failcount = 0;
     time_t last = 0;
-    GHashTableIter iter;
-
-    generate_fail_regexes(rsc, data_set, &failcount_re, &lastfailure_re);
+    const failure_totals_t *totals = get_failure_totals(node, rsc, data_set);
 
     /* Resource fail count is sum of all matching operation fail counts */
-    g_hash_table_iter_init(&iter, node->details->attrs);
-    while (g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &value)) {
-        if (regexec(&failcount_re, key, 0, NULL, 0) == 0) {
-            failcount = pcmk__add_scores(failcount, char2score(value));
-        } else if (regexec(&lastfailure_re, key, 0, NULL, 0) == 0) {
-            long long last_ll;
-
-            if (pcmk__scan_ll(value, &last_ll, 0LL) == pcmk_rc_ok) {
-                last = (time_t) QB_MAX(last, last_ll);
-            }
-        }
+    if (totals != NULL) {
+        failcount = totals->failcount;
+        last = totals->last;
     }
 
-    regfree(&failcount_re);
-    regfree(&lastfailure_re);
-
     if ((failcount > 0) && (last > 0) && (last_failure != NULL)) {
         *last_failure = last;
     }
@@ -29,6 +29,26 @@
        do_crm_log(log_level, fmt, ##args); \
    }
 
+// Lookup tables for a working set (data_set->index)
+typedef struct pe__ws_index_s {
+    GHashTable *actions;    // Graph actions (GList *) by key
+    GHashTable *resources;  // Resources by ID
+    GHashTable *renamed;    // Count of resources by clone_name
+    GHashTable *nodes;      // Nodes by uname
+    GHashTable *node_ids;   // Nodes by ID
+    GHashTable *failures;   // Failure attribute totals by node details
+} pe__ws_index_t;
+
+G_GNUC_INTERNAL
+pe__ws_index_t *pe__ws_index(const pe_working_set_t *data_set, bool create);
+
+G_GNUC_INTERNAL
+void pe__free_ws_index(pe_working_set_t *data_set);
+
+G_GNUC_INTERNAL
+void pe__clear_failure_index(const pe_node_t *node,
+                             const pe_working_set_t *data_set);
+
 G_GNUC_INTERNAL
 pe_resource_t *pe__create_clone_child(pe_resource_t *rsc,
                                       pe_working_set_t *data_set);
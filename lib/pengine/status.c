@@ -320,6 +320,7 @@ cleanup_calculations(pe_working_set_t * data_set)
     crm_time_free(data_set->now);
     free_xml(data_set->input);
     free_xml(data_set->failed);
+    pe__free_ws_index(data_set);
 
     set_working_set_defaults(data_set);
 
@@ -364,6 +365,66 @@ pe_reset_working_set(pe_working_set_t *data_set)
     cleanup_calculations(data_set);
 }
 
+/*!
+ * \internal
+ * \brief Free a working set's lookup tables, if any
+ *
+ * \param[in,out] data_set  Cluster working set
+ */
+void
+pe__free_ws_index(pe_working_set_t *data_set)
+{
+    pe__ws_index_t *index = data_set->index;
+
+    if (index == NULL) {
+        return;
+    }
+    if (index->actions != NULL) {
+        g_hash_table_destroy(index->actions);
+    }
+    if (index->resources != NULL) {
+        g_hash_table_destroy(index->resources);
+    }
+    if (index->renamed != NULL) {
+        g_hash_table_destroy(index->renamed);
+    }
+    if (index->nodes != NULL) {
+        g_hash_table_destroy(index->nodes);
+    }
+    if (index->node_ids != NULL) {
+        g_hash_table_destroy(index->node_ids);
+    }
+    if (index->failures != NULL) {
+        g_hash_table_destroy(index->failures);
+    }
+    free(index);
+    data_set->index = NULL;
+}
+
+/*!
+ * \internal
+ * \brief Get a working set's lookup tables
+ *
+ * \param[in] data_set  Cluster working set
+ * \param[in] create    Whether to create the tables entry if none exists
+ *
+ * \return Lookup tables for \p data_set (or NULL if none and \p create is
+ *         false)
+ */
+pe__ws_index_t *
+pe__ws_index(const pe_working_set_t *data_set, bool create)
+{
+    if ((data_set->index == NULL) && create) {
+        pe__ws_index_t *index = calloc(1, sizeof(pe__ws_index_t));
+
+        CRM_ASSERT(index != NULL);
+
+        // The tables only cache what the working set already holds
+        ((pe_working_set_t *) data_set)->index = index;
+    }
+    return data_set->index;
+}
+
 void
 set_working_set_defaults(pe_working_set_t * data_set)
 {
@@ -393,16 +454,181 @@ pe_find_resource(GList *rsc_list, const char *id)
     return pe_find_resource_with_flags(rsc_list, id, pe_find_renamed);
 }
 
+/*!
+ * \internal
+ * \brief Adjust the count of resources with a given clone_name
+ *
+ * \param[in,out] data_set    Cluster working set
+ * \param[in]     clone_name  Name to adjust count for
+ * \param[in]     add         Whether to increment (or decrement) count
+ */
+static void
+count_renamed(pe_working_set_t *data_set, const char *clone_name, bool add)
+{
+    pe__ws_index_t *index = NULL;
+    guint count = 0;
+
+    if (clone_name == NULL) {
+        return;
+    }
+    index = pe__ws_index(data_set, true);
+    if (index->renamed == NULL) {
+        index->renamed = pcmk__strkey_table(free, NULL);
+    }
+    count = GPOINTER_TO_UINT(g_hash_table_lookup(index->renamed, clone_name));
+    if (add) {
+        g_hash_table_insert(index->renamed, strdup(clone_name),
+                            GUINT_TO_POINTER(count + 1));
+    } else if (count > 1) {
+        g_hash_table_insert(index->renamed, strdup(clone_name),
+                            GUINT_TO_POINTER(count - 1));
+    } else {
+        g_hash_table_remove(index->renamed, clone_name);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Check whether a resource is in a working set's resource index
+ *
+ * \param[in] rsc  Resource to check
+ *
+ * \return true if \p rsc is indexed, otherwise false
+ */
+static bool
+resource_is_indexed(const pe_resource_t *rsc)
+{
+    pe__ws_index_t *index = NULL;
+
+    if (rsc->cluster == NULL) {
+        return false;
+    }
+    index = pe__ws_index(rsc->cluster, false);
+    return (index != NULL) && (index->resources != NULL)
+           && (g_hash_table_lookup(index->resources, rsc->id) == rsc);
+}
+
+/*!
+ * \internal
+ * \brief Add a resource (and its descendants) to a working set's indexes
+ *
+ * \param[in,out] data_set  Cluster working set
+ * \param[in]     rsc       Resource to add
+ *
+ * \note This must be called whenever a resource becomes reachable from
+ *       data_set->resources (whether as a new top-level resource or as a new
+ *       child of a resource that has already been indexed), so that
+ *       pe_find_resource() can use the index instead of searching the list.
+ */
+void
+pe__index_resource(pe_working_set_t *data_set, pe_resource_t *rsc)
+{
+    pe__ws_index_t *index = NULL;
+
+    CRM_CHECK((data_set != NULL) && (rsc != NULL) && (rsc->id != NULL),
+              return);
+
+    index = pe__ws_index(data_set, true);
+    if (index->resources == NULL) {
+        index->resources = pcmk__strkey_table(NULL, NULL);
+    }
+
+    // IDs should be unique, but if not, the first one found wins
+    if (g_hash_table_lookup(index->resources, rsc->id) == NULL) {
+        g_hash_table_insert(index->resources, rsc->id, rsc);
+    }
+    count_renamed(data_set, rsc->clone_name, true);
+
+    for (GList *iter = rsc->children; iter != NULL; iter = iter->next) {
+        pe__index_resource(data_set, (pe_resource_t *) iter->data);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Change the name a resource is known by in its history
+ *
+ * \param[in,out] rsc         Resource to update
+ * \param[in]     clone_name  New clone_name for \p rsc (or NULL to clear)
+ */
+void
+pe__set_clone_name(pe_resource_t *rsc, const char *clone_name)
+{
+    if (resource_is_indexed(rsc)) {
+        count_renamed(rsc->cluster, rsc->clone_name, false);
+        count_renamed(rsc->cluster, clone_name, true);
+    }
+    pcmk__str_update(&rsc->clone_name, clone_name);
+}
+
+/*!
+ * \internal
+ * \brief Find a resource in a working set's index, if possible
+ *
+ * \param[in]  rsc_list  List of resources being searched
+ * \param[in]  id        ID to search for
+ * \param[in]  flags     Group of enum pe_find flags
+ * \param[out] rsc       Where to store resource found (NULL if none)
+ *
+ * \return true if the search could be answered from the index (in which case
+ *         \p rsc is what a search of \p rsc_list would find), otherwise false
+ */
+static bool
+find_indexed_resource(GList *rsc_list, const char *id, enum pe_find flags,
+                      pe_resource_t **rsc)
+{
+    pe_working_set_t *data_set = NULL;
+    pe__ws_index_t *index = NULL;
+
+    if ((rsc_list == NULL) || (id == NULL)) {
+        return false;
+    }
+
+    data_set = ((pe_resource_t *) rsc_list->data)->cluster;
+    if ((data_set == NULL) || (rsc_list != data_set->resources)) {
+        return false;
+    }
+    index = pe__ws_index(data_set, false);
+    if ((index == NULL) || (index->resources == NULL)) {
+        return false;
+    }
+
+    /* Only exact ID matches can be looked up. If a resource is known by the
+     * given ID in its history, it could come before the resource with that ID,
+     * so that needs a full search.
+     */
+    if (pcmk_is_set(flags, pe_find_renamed)) {
+        if ((index->renamed != NULL)
+            && g_hash_table_contains(index->renamed, id)) {
+            return false;
+        }
+        flags &= ~pe_find_renamed;
+    }
+    if (flags != 0) {
+        return false;
+    }
+
+    *rsc = g_hash_table_lookup(index->resources, id);
+    return true;
+}
+
 pe_resource_t *
 pe_find_resource_with_flags(GList *rsc_list, const char *id, enum pe_find flags)
 {
     GList *rIter = NULL;
+    pe_resource_t *match = NULL;
+
+    if (find_indexed_resource(rsc_list, id, flags, &match)) {
+        if (match == NULL) {
+            crm_trace("No match for %s", id);
+        }
+        return match;
+    }
 
     for (rIter = rsc_list; id && rIter; rIter = rIter->next) {
         pe_resource_t *parent = rIter->data;
 
-        pe_resource_t *match =
-            parent->fns->find_rsc(parent, id, NULL, flags);
+        match = parent->fns->find_rsc(parent, id, NULL, flags);
         if (match != NULL) {
             return match;
         }
@@ -411,6 +637,85 @@ pe_find_resource_with_flags(GList *rsc_list, const char *id, enum pe_find flags)
     return NULL;
 }
 
+/*!
+ * \internal
+ * \brief Add a node entry to a node index table
+ *
+ * \param[in,out] table  Index table to add node to
+ * \param[in]     key    Key to index node by
+ * \param[in]     node   Node to add
+ *
+ * \note If more than one node has the same key, the index must have the one
+ *       that comes first in data_set->nodes (which is sorted by name), to
+ *       match what a search of the list would find.
+ */
+static void
+index_node_by(GHashTable *table, const char *key, pe_node_t *node)
+{
+    pe_node_t *existing = NULL;
+
+    if (key == NULL) {
+        return;
+    }
+    existing = g_hash_table_lookup(table, key);
+    if ((existing == NULL) || (sort_node_uname(node, existing) <= 0)) {
+        g_hash_table_replace(table, (gpointer) key, node);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Add a node to a working set's node indexes
+ *
+ * \param[in,out] data_set  Cluster working set
+ * \param[in]     node      Node to add (which must be in data_set->nodes)
+ */
+void
+pe__index_node(pe_working_set_t *data_set, pe_node_t *node)
+{
+    pe__ws_index_t *index = NULL;
+
+    CRM_CHECK((data_set != NULL) && (node != NULL), return);
+
+    index = pe__ws_index(data_set, true);
+    if (index->nodes == NULL) {
+        index->nodes = pcmk__strikey_table(NULL, NULL);
+        index->node_ids = pcmk__strikey_table(NULL, NULL);
+    }
+    index_node_by(index->nodes, node->details->uname, node);
+    index_node_by(index->node_ids, node->details->id, node);
+}
+
+/*!
+ * \internal
+ * \brief Get the appropriate node index for a node list, if any
+ *
+ * \param[in] nodes  List of nodes being searched
+ * \param[in] by_id  If true, get ID index, otherwise name index
+ *
+ * \return Index table if \p nodes is a working set's node list and is
+ *         indexed, otherwise NULL
+ */
+static GHashTable *
+node_index_for(GList *nodes, bool by_id)
+{
+    pe_working_set_t *data_set = NULL;
+    pe__ws_index_t *index = NULL;
+
+    if ((nodes == NULL) || (nodes->data == NULL)) {
+        return NULL;
+    }
+    data_set = ((pe_node_t *) nodes->data)->details->data_set;
+    if ((data_set == NULL) || (nodes != data_set->nodes)) {
+        return NULL;
+    }
+    index = pe__ws_index(data_set, false);
+    if (index == NULL) {
+        return NULL;
+    }
+    return by_id? index->node_ids : index->nodes;
+}
+
 pe_node_t *
 pe_find_node_any(GList *nodes, const char *id, const char *uname)
 {
@@ -427,6 +732,11 @@ pe_node_t *
 pe_find_node_id(GList *nodes, const char *id)
 {
     GList *gIter = nodes;
+    GHashTable *index = node_index_for(nodes, true);
+
+    if ((index != NULL) && (id != NULL)) {
+        return g_hash_table_lookup(index, id);
+    }
 
     for (; gIter != NULL; gIter = gIter->next) {
         pe_node_t *node = (pe_node_t *) gIter->data;
@@ -443,6 +753,11 @@ pe_node_t *
 pe_find_node(GList *nodes, const char *uname)
 {
     GList *gIter = nodes;
+    GHashTable *index = node_index_for(nodes, false);
+
+    if ((index != NULL) && (uname != NULL)) {
+        return g_hash_table_lookup(index, uname);
+    }
 
     for (; gIter != NULL; gIter = gIter->next) {
         pe_node_t *node = (pe_node_t *) gIter->data;
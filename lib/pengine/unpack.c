@@ -447,6 +447,7 @@ pe_create_node(const char *id, const char *uname, const char *type,
                                                           pe__free_digests);
 
     data_set->nodes = g_list_insert_sorted(data_set->nodes, new_node, sort_node_uname);
+    pe__index_node(data_set, new_node);
     return new_node;
 }
 
@@ -735,6 +736,7 @@ link_rsc2remotenode(pe_working_set_t *data_set, pe_resource_t *new_rsc)
          */
         g_hash_table_replace(remote_node->details->attrs, strdup(CRM_ATTR_KIND),
                              strdup("container"));
+        pe__clear_failure_index(remote_node, data_set);
     }
 }
 
@@ -789,6 +791,7 @@ unpack_resources(xmlNode * xml_resources, pe_working_set_t * data_set)
         crm_trace("Beginning unpack... <%s id=%s... >", crm_element_name(xml_obj), ID(xml_obj));
         if (common_unpack(xml_obj, &new_rsc, NULL, data_set) && (new_rsc != NULL)) {
             data_set->resources = g_list_append(data_set->resources, new_rsc);
+            pe__index_resource(data_set, new_rsc);
             pe_rsc_trace(new_rsc, "Added resource %s", new_rsc->id);
 
         } else {
@@ -1706,6 +1709,7 @@ create_fake_resource(const char *rsc_id, xmlNode * rsc_entry, pe_working_set_t *
     }
     pe__set_resource_flags(rsc, pe_rsc_orphan);
     data_set->resources = g_list_append(data_set->resources, rsc);
+    pe__index_resource(data_set, rsc);
     return rsc;
 }
 
@@ -1917,7 +1921,7 @@ unpack_find_resource(pe_working_set_t * data_set, pe_node_t * node, const char *
     if (rsc && !pcmk__str_eq(rsc_id, rsc->id, pcmk__str_casei)
         && !pcmk__str_eq(rsc_id, rsc->clone_name, pcmk__str_casei)) {
 
-        pcmk__str_update(&rsc->clone_name, rsc_id);
+        pe__set_clone_name(rsc, rsc_id);
         pe_rsc_debug(rsc, "Internally renamed %s on %s to %s%s",
                      rsc_id, node->details->uname, rsc->id,
                      (pcmk_is_set(rsc->flags, pe_rsc_orphan)? " (ORPHAN)" : ""));
@@ -2178,8 +2182,7 @@ process_rsc_state(pe_resource_t * rsc, pe_node_t * node,
          * Otherwise stopped instances will appear as orphans
          */
         pe_rsc_trace(rsc, "Resetting clone_name %s for %s (stopped)", rsc->clone_name, rsc->id);
-        free(rsc->clone_name);
-        rsc->clone_name = NULL;
+        pe__set_clone_name(rsc, NULL);
 
     } else {
         GList *possible_matches = pe__resource_actions(rsc, node, RSC_STOP,
@@ -4001,6 +4004,7 @@ add_node_attrs(xmlNode *xml_obj, pe_node_t *node, bool overwrite,
                                 strdup(cluster_name));
         }
     }
+    pe__clear_failure_index(node, data_set);
 }
 
 static GList *
@@ -419,6 +419,37 @@ add_singleton(pe_working_set_t *data_set, pe_action_t *action)
     g_hash_table_insert(data_set->singletons, action->uuid, action);
 }
 
+/*!
+ * \internal
+ * \brief Add an action to a working set's index of actions by key
+ *
+ * \param[in,out] data_set  Cluster working set
+ * \param[in]     action    Action to add
+ *
+ * \note The index holds all actions that are in data_set->actions, so that
+ *       find_existing_action() doesn't need to scan the full action list.
+ */
+static void
+index_action(pe_working_set_t *data_set, pe_action_t *action)
+{
+    pe__ws_index_t *index = pe__ws_index(data_set, true);
+    GList *matches = NULL;
+
+    if (index->actions == NULL) {
+        index->actions = pcmk__strikey_table(NULL,
+                                             (GDestroyNotify) g_list_free);
+    }
+
+    matches = g_hash_table_lookup(index->actions, action->uuid);
+    if (matches == NULL) {
+        g_hash_table_insert(index->actions, action->uuid,
+                            g_list_prepend(NULL, action));
+    } else {
+        // Insert after the first item, so the table's value remains valid
+        g_list_insert(matches, action, 1);
+    }
+}
+
 static pe_action_t *
 lookup_singleton(pe_working_set_t *data_set, const char *action_uuid)
 {
@@ -443,14 +474,37 @@ static pe_action_t *
 find_existing_action(const char *key, pe_resource_t *rsc, pe_node_t *node,
                      pe_working_set_t *data_set)
 {
+    pe__ws_index_t *index = pe__ws_index(data_set, false);
+    GList *candidates = NULL;
     GList *matches = NULL;
     pe_action_t *action = NULL;
 
-    /* When rsc is NULL, it would be quicker to check data_set->singletons,
-     * but checking all data_set->actions takes the node into account.
-     */
-    matches = find_actions(((rsc == NULL)? data_set->actions : rsc->actions),
-                           key, node);
+    if ((index == NULL) || (index->actions == NULL)) {
+        return NULL;
+    }
+    candidates = g_hash_table_lookup(index->actions, key);
+
+    if (rsc == NULL) {
+        /* When rsc is NULL, it would be quicker to check
+         * data_set->singletons, but checking the index takes the node into
+         * account.
+         */
+        matches = find_actions(candidates, key, node);
+
+    } else {
+        GList *rsc_candidates = NULL;
+
+        for (GList *iter = candidates; iter != NULL; iter = iter->next) {
+            pe_action_t *candidate = (pe_action_t *) iter->data;
+
+            if (candidate->rsc == rsc) {
+                rsc_candidates = g_list_prepend(rsc_candidates, candidate);
+            }
+        }
+        matches = find_actions(rsc_candidates, key, node);
+        g_list_free(rsc_candidates);
+    }
+
     if (matches == NULL) {
         return NULL;
     }
@@ -525,6 +579,7 @@ new_action(char *key, const char *task, pe_resource_t *rsc, pe_node_t *node,
         action->id = data_set->action_id++;
 
         data_set->actions = g_list_prepend(data_set->actions, action);
+        index_action(data_set, action);
         if (rsc == NULL) {
             add_singleton(data_set, action);
         } else {
@@ -1453,6 +1508,11 @@ print_str_str(gpointer key, gpointer value, gpointer user_data)
               user_data == NULL ? "" : ": ", (char *)key, (char *)value);
 }
 
+/* Once an action has this many orderings after it, track them in a table
+ * rather than scanning the list for duplicates
+ */
+#define ORDERING_INDEX_THRESHOLD 16
+
 void
 pe_free_action(pe_action_t * action)
 {
@@ -1461,6 +1521,9 @@ pe_free_action(pe_action_t * action)
     }
     g_list_free_full(action->actions_before, free);     /* pe_action_wrapper_t* */
     g_list_free_full(action->actions_after, free);      /* pe_action_wrapper_t* */
+    if (action->after_types != NULL) {
+        g_hash_table_destroy(action->after_types);
+    }
     if (action->extra) {
         g_hash_table_destroy(action->extra);
     }
@@ -1902,11 +1965,68 @@ get_target_role(pe_resource_t * rsc, enum rsc_role_e * role)
     return TRUE;
 }
 
+
+/*!
+ * \internal
+ * \brief Check whether an equivalent ordering already exists
+ *
+ * \param[in,out] lh_action  'First' action in ordering
+ * \param[in]     rh_action  'Then' action in ordering
+ * \param[in]     order      Ordering type
+ *
+ * \return true if \p lh_action already has an ordering before \p rh_action
+ *         that shares any of the flags in \p order, otherwise false
+ */
+static bool
+ordering_exists(pe_action_t *lh_action, const pe_action_t *rh_action,
+                enum pe_ordering order)
+{
+    GHashTable *types_by_action = lh_action->after_types;
+
+    if ((types_by_action == NULL)
+        && (g_list_length(lh_action->actions_after)
+            >= ORDERING_INDEX_THRESHOLD)) {
+
+        types_by_action = g_hash_table_new(NULL, NULL);
+        lh_action->after_types = types_by_action;
+
+        for (GList *iter = lh_action->actions_after; iter != NULL;
+             iter = iter->next) {
+            pe_action_wrapper_t *after = (pe_action_wrapper_t *) iter->data;
+            guint types = GPOINTER_TO_UINT(g_hash_table_lookup(
+                              types_by_action, after->action));
+
+            g_hash_table_insert(types_by_action, after->action,
+                                GUINT_TO_POINTER(types | after->type));
+        }
+    }
+
+    if (types_by_action != NULL) {
+        /* An existing ordering shares a flag with the new one exactly when
+         * the combination of all existing orderings does
+         */
+        guint types = GPOINTER_TO_UINT(g_hash_table_lookup(types_by_action,
+                                                           rh_action));
+
+        return pcmk_any_flags_set(types, order);
+    }
+
+    for (GList *iter = lh_action->actions_after; iter != NULL;
+         iter = iter->next) {
+        pe_action_wrapper_t *after = (pe_action_wrapper_t *) iter->data;
+
+        if (after->action == rh_action && (after->type & order)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 gboolean
 order_actions(pe_action_t * lh_action, pe_action_t * rh_action, enum pe_ordering order)
 {
-    GList *gIter = NULL;
     pe_action_wrapper_t *wrapper = NULL;
+    GHashTable *types_by_action = NULL;
     GList *list = NULL;
 
     if (order == pe_order_none) {
@@ -1924,13 +2044,8 @@ order_actions(pe_action_t * lh_action, pe_action_t * rh_action, enum pe_ordering
     CRM_ASSERT(lh_action != rh_action);
 
     /* Filter dups, otherwise update_action_states() has too much work to do */
-    gIter = lh_action->actions_after;
-    for (; gIter != NULL; gIter = gIter->next) {
-        pe_action_wrapper_t *after = (pe_action_wrapper_t *) gIter->data;
-
-        if (after->action == rh_action && (after->type & order)) {
-            return FALSE;
-        }
+    if (ordering_exists(lh_action, rh_action, order)) {
+        return FALSE;
     }
 
     wrapper = calloc(1, sizeof(pe_action_wrapper_t));
@@ -1940,6 +2055,15 @@ order_actions(pe_action_t * lh_action, pe_action_t * rh_action, enum pe_ordering
     list = g_list_prepend(list, wrapper);
     lh_action->actions_after = list;
 
+    types_by_action = lh_action->after_types;
+    if (types_by_action != NULL) {
+        guint types = GPOINTER_TO_UINT(g_hash_table_lookup(types_by_action,
+                                                           rh_action));
+
+        g_hash_table_insert(types_by_action, rh_action,
+                            GUINT_TO_POINTER(types | order));
+    }
+
     wrapper = calloc(1, sizeof(pe_action_wrapper_t));
     wrapper->action = lh_action;
     wrapper->type = order;
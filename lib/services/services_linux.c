@@ -14,15 +14,23 @@
 #endif
 
 #include <sys/types.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <grp.h>
 #include <string.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <signal.h>
+
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+#  include <spawn.h>
+#  include <sched.h>
+#endif
 
 #include "crm/crm.h"
 #include "crm/common/mainloop.h"
@@ -360,10 +368,19 @@ static struct mainloop_fd_callbacks stderr_callbacks = {
     .destroy = pipe_err_done,
 };
 
+/* The environment setters below take a table of environment variables as user
+ * data. If the table is NULL, they set the current process's environment
+ * instead (which is what a forked child does).
+ */
+
 static void
 set_ocf_env(const char *key, const char *value, gpointer user_data)
 {
-    if (setenv(key, value, 1) != 0) {
+    if (user_data != NULL) {
+        g_hash_table_replace((GHashTable *) user_data, strdup(key),
+                             strdup(value));
+
+    } else if (setenv(key, value, 1) != 0) {
         crm_perror(LOG_ERR, "setenv failed for key:%s and value:%s", key, value);
     }
 }
@@ -382,6 +399,16 @@ set_alert_env(gpointer key, gpointer value, gpointer user_data)
 {
     int rc;
 
+    if (user_data != NULL) {
+        if (value != NULL) {
+            g_hash_table_replace((GHashTable *) user_data, strdup(key),
+                                 strdup(value));
+        } else {
+            g_hash_table_remove((GHashTable *) user_data, key);
+        }
+        return;
+    }
+
     if (value != NULL) {
         rc = setenv(key, value, 1);
     } else {
@@ -400,10 +427,12 @@ set_alert_env(gpointer key, gpointer value, gpointer user_data)
  * \internal
  * \brief Add environment variables suitable for an action
  *
- * \param[in] op  Action to use
+ * \param[in]     op   Action to use
+ * \param[in,out] env  Table of environment variables to add to (or NULL to
+ *                     set them in the current process's environment)
  */
 static void
-add_action_env_vars(const svc_action_t *op)
+add_action_env_vars(const svc_action_t *op, GHashTable *env)
 {
     void (*env_setter)(gpointer, gpointer, gpointer) = NULL;
     if (op->agent == NULL) {
@@ -414,29 +443,29 @@ add_action_env_vars(const svc_action_t *op)
     }
 
     if (env_setter != NULL && op->params != NULL) {
-        g_hash_table_foreach(op->params, env_setter, NULL);
+        g_hash_table_foreach(op->params, env_setter, env);
     }
 
     if (env_setter == NULL || env_setter == set_alert_env) {
         return;
     }
 
-    set_ocf_env("OCF_RA_VERSION_MAJOR", PCMK_OCF_MAJOR_VERSION, NULL);
-    set_ocf_env("OCF_RA_VERSION_MINOR", PCMK_OCF_MINOR_VERSION, NULL);
-    set_ocf_env("OCF_ROOT", OCF_ROOT_DIR, NULL);
-    set_ocf_env("OCF_EXIT_REASON_PREFIX", PCMK_OCF_REASON_PREFIX, NULL);
+    set_ocf_env("OCF_RA_VERSION_MAJOR", PCMK_OCF_MAJOR_VERSION, env);
+    set_ocf_env("OCF_RA_VERSION_MINOR", PCMK_OCF_MINOR_VERSION, env);
+    set_ocf_env("OCF_ROOT", OCF_ROOT_DIR, env);
+    set_ocf_env("OCF_EXIT_REASON_PREFIX", PCMK_OCF_REASON_PREFIX, env);
 
     if (op->rsc) {
-        set_ocf_env("OCF_RESOURCE_INSTANCE", op->rsc, NULL);
+        set_ocf_env("OCF_RESOURCE_INSTANCE", op->rsc, env);
     }
 
     if (op->agent != NULL) {
-        set_ocf_env("OCF_RESOURCE_TYPE", op->agent, NULL);
+        set_ocf_env("OCF_RESOURCE_TYPE", op->agent, env);
     }
 
     /* Notes: this is not added to specification yet. Sept 10,2004 */
     if (op->provider != NULL) {
-        set_ocf_env("OCF_RESOURCE_PROVIDER", op->provider, NULL);
+        set_ocf_env("OCF_RESOURCE_PROVIDER", op->provider, env);
     }
 }
 
@@ -968,7 +997,7 @@ action_launch_child(svc_action_t *op)
     }
 #endif
 
-    add_action_env_vars(op);
+    add_action_env_vars(op, NULL);
 
     /* Become the desired user */
     if (op->opaque->uid && (geteuid() == 0)) {
@@ -1010,6 +1039,204 @@ action_launch_child(svc_action_t *op)
     exit_child(op, op->rc, "Child process was unable to execute file");
 }
 
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+
+/*!
+ * \internal
+ * \brief Check whether an action's child can be launched with posix_spawn()
+ *
+ * action_launch_child() does some things that posix_spawn() can't (or that
+ * would need the action's secrets in the parent), so only spawn children that
+ * don't need them.
+ *
+ * \param[in] op  Action to check
+ *
+ * \return true if \p op's child can be spawned, otherwise false
+ */
+static bool
+can_spawn_child(const svc_action_t *op)
+{
+    if (op->synchronous) {
+        return false; // Signal mask handling is only done after fork()
+    }
+
+    if (op->opaque->uid && (geteuid() == 0)) {
+        return false; // Would need to change user
+    }
+
+    errno = 0;
+    if ((getpriority(PRIO_PROCESS, 0) != 0) || (errno != 0)) {
+        return false; // Would need to reset priority
+    }
+
+#if SUPPORT_CIBSECRETS
+    if (op->params != NULL) {
+        GHashTableIter iter;
+        const char *value = NULL;
+
+        g_hash_table_iter_init(&iter, op->params);
+        while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &value)) {
+            if (pcmk__str_eq(value, "lrm://", pcmk__str_none)) {
+                return false; // Would need to substitute secrets
+            }
+        }
+    }
+#endif
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Build the environment for an action's child ahead of spawning it
+ *
+ * \param[in] op  Action to build environment for
+ *
+ * \return Newly allocated NULL-terminated array of "NAME=VALUE" strings
+ * \note The caller is responsible for freeing the result with
+ *       free_child_env().
+ */
+static char **
+build_child_env(const svc_action_t *op)
+{
+    GHashTable *env = pcmk__strkey_table(free, free);
+    GHashTableIter iter;
+    const char *name = NULL;
+    const char *value = NULL;
+    char **envp = NULL;
+    int i = 0;
+
+    for (char **var = environ; *var != NULL; var++) {
+        char *eq = strchr(*var, '=');
+
+        if (eq != NULL) {
+            g_hash_table_replace(env, strndup(*var, eq - *var),
+                                 strdup(eq + 1));
+        }
+    }
+    add_action_env_vars(op, env);
+
+    envp = calloc(g_hash_table_size(env) + 1, sizeof(char *));
+    CRM_ASSERT(envp != NULL);
+
+    g_hash_table_iter_init(&iter, env);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &name,
+                                  (gpointer *) &value)) {
+        envp[i++] = crm_strdup_printf("%s=%s", name, value);
+    }
+    g_hash_table_destroy(env);
+    return envp;
+}
+
+static void
+free_child_env(char **envp)
+{
+    for (char **var = envp; *var != NULL; var++) {
+        free(*var);
+    }
+    free(envp);
+}
+
+/*!
+ * \internal
+ * \brief Launch an action's child with posix_spawn() instead of fork()
+ *
+ * With a large heap, fork() is expensive even though the child only execs,
+ * because the page tables must be copied. posix_spawn() avoids that (glibc
+ * uses clone(CLONE_VM|CLONE_VFORK)), so we use it when the child needs no
+ * setup beyond what posix_spawn() can do.
+ *
+ * \param[in,out] op         Action to launch child for (pid will be set)
+ * \param[in]     stdin_fd   Pipe for child's standard input (or -1's)
+ * \param[in]     stdout_fd  Pipe for child's standard output
+ * \param[in]     stderr_fd  Pipe for child's standard error
+ *
+ * \return Standard Pacemaker return code (ENOTSUP if the child must be forked)
+ * \note This is optional. It is only built if the C library has
+ *       posix_spawn_file_actions_addclosefrom_np() (glibc 2.34 or later), which
+ *       is needed to close inherited descriptors in the child.
+ */
+static int
+spawn_child(svc_action_t *op, int stdin_fd[], int stdout_fd[],
+            int stderr_fd[])
+{
+    int rc = pcmk_rc_ok;
+    short flags = POSIX_SPAWN_SETPGROUP|POSIX_SPAWN_SETSIGDEF
+                  |POSIX_SPAWN_SETSIGMASK;
+    sigset_t sigdefault;
+    sigset_t sigmask;
+    char **envp = NULL;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_t actions;
+
+    if (!can_spawn_child(op)) {
+        return ENOTSUP;
+    }
+
+    posix_spawnattr_init(&attr);
+    posix_spawn_file_actions_init(&actions);
+
+    // Same as setpgid(0, 0) in action_launch_child()
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    // SIGPIPE may be ignored by us (see action_launch_child())
+    sigemptyset(&sigdefault);
+    sigaddset(&sigdefault, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attr, &sigdefault);
+
+    // Keep the current signal mask, as a forked child would
+    pthread_sigmask(SIG_SETMASK, NULL, &sigmask);
+    posix_spawnattr_setsigmask(&attr, &sigmask);
+
+#if defined(HAVE_SCHED_SETSCHEDULER)
+    if (sched_getscheduler(0) != SCHED_OTHER) {
+        struct sched_param sp;
+
+        memset(&sp, 0, sizeof(sp));
+        sp.sched_priority = 0;
+        posix_spawnattr_setschedpolicy(&attr, SCHED_OTHER);
+        posix_spawnattr_setschedparam(&attr, &sp);
+        flags |= POSIX_SPAWN_SETSCHEDULER;
+    }
+#endif
+    posix_spawnattr_setflags(&attr, flags);
+
+    if (stdin_fd[0] >= 0) {
+        posix_spawn_file_actions_adddup2(&actions, stdin_fd[0], STDIN_FILENO);
+    }
+    posix_spawn_file_actions_adddup2(&actions, stdout_fd[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, stderr_fd[1], STDERR_FILENO);
+
+    // Same as pcmk__close_fds_in_child(false), including our ends of pipes
+    posix_spawn_file_actions_addclosefrom_np(&actions, STDERR_FILENO + 1);
+
+    envp = build_child_env(op);
+    rc = posix_spawnp(&(op->pid), op->opaque->exec, &actions, &attr,
+                      op->opaque->args, envp);
+    free_child_env(envp);
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    if (rc != 0) {
+        op->pid = 0;
+        return rc;
+    }
+    crm_trace("Spawned '%s'[%d] without forking", op->opaque->exec, op->pid);
+    return pcmk_rc_ok;
+}
+
+#else
+
+// Without posix_spawn_file_actions_addclosefrom_np(), always fork()
+static int
+spawn_child(svc_action_t *op, int stdin_fd[], int stdout_fd[],
+            int stderr_fd[])
+{
+    return ENOTSUP;
+}
+
+#endif // HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+
 /*!
  * \internal
  * \brief Wait for synchronous action to complete, and set its result
@@ -1226,7 +1453,19 @@ services__execute_file(svc_action_t *op)
         goto done;
     }
 
-    op->pid = fork();
+    rc = spawn_child(op, stdin_fd, stdout_fd, stderr_fd);
+    if ((rc != pcmk_rc_ok) && (rc != ENOTSUP)) {
+        close_pipe(stdin_fd);
+        close_pipe(stdout_fd);
+        close_pipe(stderr_fd);
+
+        crm_info("Cannot execute '%s': %s " CRM_XS " posix_spawn rc=%d",
+                 op->opaque->exec, pcmk_rc_str(rc), rc);
+        services__handle_exec_error(op, rc);
+        goto done;
+    }
+
+    op->pid = (rc == ENOTSUP)? fork() : op->pid;
     switch (op->pid) {
         case -1:
             rc = errno;
@@ -1357,6 +1596,90 @@ done:
     }
 }
 
+/*!
+ * \internal
+ * \brief Launch an action's agent as a coprocess that keeps running
+ *
+ * Unlike services__execute_file(), this neither waits for the child nor
+ * collects its output. The child's standard input and output are connected to
+ * one end of a socket pair, the other end of which is returned to the caller,
+ * and the child's error output is discarded.
+ *
+ * \param[in,out] op  Action to launch agent for (its pid will be set)
+ * \param[out]    fd  Where to store caller's end of socket pair
+ *
+ * \return Standard Pacemaker return code
+ * \note The caller is responsible for tracking the child (for example, with
+ *       mainloop_child_add()) and for closing \p fd.
+ */
+int
+services__launch_coprocess(svc_action_t *op, int *fd)
+{
+    int sock_fd[2] = {-1, -1};
+    int rc = pcmk_rc_ok;
+    struct stat st;
+
+    CRM_CHECK((op != NULL) && (fd != NULL), return EINVAL);
+    *fd = -1;
+
+    if (stat(op->opaque->exec, &st) != 0) {
+        rc = errno;
+        crm_info("Cannot execute '%s': %s " CRM_XS " stat rc=%d",
+                 op->opaque->exec, pcmk_rc_str(rc), rc);
+        return rc;
+    }
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sock_fd) < 0) {
+        rc = errno;
+        crm_info("Cannot execute '%s': %s " CRM_XS " socketpair rc=%d",
+                 op->opaque->exec, pcmk_rc_str(rc), rc);
+        return rc;
+    }
+
+    op->pid = fork();
+    switch (op->pid) {
+        case -1:
+            rc = errno;
+            op->pid = 0;
+            close_pipe(sock_fd);
+            crm_info("Cannot execute '%s': %s " CRM_XS " fork rc=%d",
+                     op->opaque->exec, pcmk_rc_str(rc), rc);
+            return rc;
+
+        case 0:                /* Child */
+            close(sock_fd[0]);
+            if ((dup2(sock_fd[1], STDIN_FILENO) != STDIN_FILENO)
+                || (dup2(sock_fd[1], STDOUT_FILENO) != STDOUT_FILENO)) {
+                crm_warn("Can't redirect input and output of '%s': %s "
+                         CRM_XS " errno=%d",
+                         op->opaque->exec, pcmk_rc_str(errno), errno);
+            }
+            close(sock_fd[1]);
+
+            rc = open("/dev/null", O_WRONLY);
+            if (rc >= 0) {
+                dup2(rc, STDERR_FILENO);
+                close(rc);
+            }
+
+            action_launch_child(op);
+            CRM_ASSERT(0);  /* action_launch_child is effectively noreturn */
+    }
+
+    /* Only the parent reaches here */
+    close(sock_fd[1]);
+    *fd = sock_fd[0];
+
+    rc = pcmk__set_nonblocking(*fd);
+    if (rc != pcmk_rc_ok) {
+        crm_info("Could not set '%s' connection non-blocking: %s "
+                 CRM_XS " rc=%d",
+                 op->opaque->exec, pcmk_rc_str(rc), rc);
+    }
+    crm_trace("Launched '%s'[%d] as coprocess", op->opaque->exec, op->pid);
+    return pcmk_rc_ok;
+}
+
 GList *
 services_os_get_single_directory_list(const char *root, gboolean files, gboolean executable)
 {
@@ -68,6 +68,8 @@ command_cb (const gchar *option_name, const gchar *optarg, gpointer data, GError
         options.command = 'R';
     } else if (pcmk__str_any_of(option_name, "--update", "-U", "-v", NULL)) {
         options.command = 'U';
+    } else if (pcmk__str_any_of(option_name, "--update-stdin", NULL)) {
+        options.command = 'L';
     }
 
     return TRUE;
@@ -111,6 +113,14 @@ static GOptionEntry command_entries[] = {
       INDENT "effectiveness.",
       NULL },
 
+    { "update-stdin", 0, G_OPTION_FLAG_NO_ARG, G_OPTION_ARG_CALLBACK, command_cb,
+      "Update the values of all attributes listed on standard input, one\n"
+      INDENT "NAME=VALUE pair per line, in a single request (a line with only\n"
+      INDENT "NAME deletes that attribute). Blank lines and lines starting\n"
+      INDENT "with '#' are ignored. The other options given apply to every\n"
+      INDENT "attribute.",
+      NULL },
+
     { "query", 'Q', G_OPTION_FLAG_NO_ARG, G_OPTION_ARG_CALLBACK, command_cb,
       "Query the attribute's value from pacemaker-attrd",
       NULL },
@@ -176,6 +186,9 @@ static int do_query(pcmk__output_t *out, const char *attr_name, const char *attr
 static int do_update(char command, const char *attr_node, const char *attr_name,
                      const char *attr_value, const char *attr_section,
                      const char *attr_set, const char *attr_dampen, int attr_options);
+static int do_update_list(FILE *stream, const char *attr_node,
+                          const char *attr_section, const char *attr_set,
+                          const char *attr_dampen, int attr_options);
 
 static GOptionContext *
 build_arg_context(pcmk__common_args_t *args, GOptionGroup **group) {
@@ -229,7 +242,8 @@ main(int argc, char **argv)
         goto done;
     }
 
-    if (options.command != 'R' && options.attr_name == NULL) {
+    if ((options.command != 'R') && (options.command != 'L')
+        && (options.attr_name == NULL)) {
         exit_code = CRM_EX_USAGE;
         g_set_error(&error, PCMK__EXITC_ERROR, exit_code, "Command requires --name argument");
         goto done;
@@ -248,11 +262,18 @@ main(int argc, char **argv)
          */
         const char *target = pcmk__node_attr_target(options.attr_node);
 
-        exit_code = pcmk_rc2exitc(do_update(options.command,
-                                            target == NULL ? options.attr_node : target,
-                                            options.attr_name, options.attr_value,
-                                            options.attr_section, options.attr_set,
-                                            options.attr_dampen, options.attr_options));
+        if (options.command == 'L') {
+            exit_code = pcmk_rc2exitc(do_update_list(stdin,
+                                                     target == NULL ? options.attr_node : target,
+                                                     options.attr_section, options.attr_set,
+                                                     options.attr_dampen, options.attr_options));
+        } else {
+            exit_code = pcmk_rc2exitc(do_update(options.command,
+                                                target == NULL ? options.attr_node : target,
+                                                options.attr_name, options.attr_value,
+                                                options.attr_section, options.attr_set,
+                                                options.attr_dampen, options.attr_options));
+        }
     }
 
 done:
@@ -476,3 +497,73 @@ do_update(char command, const char *attr_node, const char *attr_name,
     }
     return rc;
 }
+
+/*!
+ * \internal
+ * \brief Update all attributes listed in a stream with a single request
+ *
+ * \param[in] stream        Stream with one NAME=VALUE pair (or NAME, to delete)
+ *                          per line
+ * \param[in] attr_node     Name of host to update (or NULL for localhost)
+ * \param[in] attr_section  Status or nodes
+ * \param[in] attr_set      ID of attribute set to use (or NULL for first)
+ * \param[in] attr_dampen   Attribute dampening to use if creating attributes
+ * \param[in] attr_options  Bitmask of pcmk__node_attr_opts
+ *
+ * \return Standard Pacemaker return code
+ */
+static int
+do_update_list(FILE *stream, const char *attr_node, const char *attr_section,
+               const char *attr_set, const char *attr_dampen, int attr_options)
+{
+    int rc = pcmk_rc_ok;
+    int line_num = 0;
+    char *line = NULL;
+    size_t line_len = 0;
+    GSList *attrs = NULL;
+
+    while (getline(&line, &line_len, stream) >= 0) {
+        char *name = NULL;
+        char *value = NULL;
+
+        line_num++;
+        pcmk__trim(line);
+
+        if ((line[0] == '\0') || (line[0] == '#')) {
+            continue;
+        }
+
+        name = line;
+        value = strchr(line, '=');
+        if (value != NULL) {
+            *value++ = '\0';
+        }
+        if (name[0] == '\0') {
+            rc = pcmk_rc_bad_nvpair;
+            g_set_error(&error, PCMK__RC_ERROR, rc,
+                        "Could not update attributes: line %d has no name",
+                        line_num);
+            goto done;
+        }
+        attrs = pcmk_prepend_nvpair(attrs, name, value);
+    }
+
+    if (attrs == NULL) {
+        goto done;
+    }
+    attrs = g_slist_reverse(attrs);
+
+    rc = pcmk__node_attr_update_list(NULL, attr_node, attrs, attr_section,
+                                     attr_set, attr_dampen, NULL, attr_options);
+    if (rc != pcmk_rc_ok) {
+        g_set_error(&error, PCMK__RC_ERROR, rc,
+                    "Could not update %d attribute%s: %s (%d)",
+                    g_slist_length(attrs), pcmk__plural_s(g_slist_length(attrs)),
+                    pcmk_rc_str(rc), rc);
+    }
+
+done:
+    free(line);
+    pcmk_free_nvpairs(attrs);
+    return rc;
+}
@@ -249,7 +249,8 @@ static GOptionEntry operation_entries[] = {
       "Show utilization information",
       NULL },
     { "profile", 'P', 0, G_OPTION_ARG_FILENAME, &options.test_dir,
-      "Process all the XML files in the named directory to create profiling data",
+      "Process all the XML files in the named directory to create profiling data\n"
+      INDENT "(including time spent in each scheduler phase)",
       "DIR" },
     { "repeat", 'N', 0, G_OPTION_ARG_INT, &options.repeat,
       "With --profile, repeat each test N times and print timings",